@@ -0,0 +1 @@
+../TemperatureController/AppProfile.h
\ No newline at end of file
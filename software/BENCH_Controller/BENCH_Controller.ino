@@ -0,0 +1,367 @@
+/******************************************************************************
+ Controller Benchmarks
+
+ DESCRIPTION: Times the Temperature Controller's hot paths on the chip
+  itself, in CPU cycles, so a rewrite is judged on real numbers:
+    * reading the LM19 as a temperature
+    * reading the pot as a set-point
+    * one EMA update of the filtered temperature
+    * StatusLeds working out the region (setDisplayState()/setCounts())
+    * StatusLeds driving the LEDs (updateLEDs())
+
+ NOTES:
+  - Build it once per BENCH_VARIANT: BENCH_FLOAT is the original float
+    pipeline with digitalWrite() LEDs, BENCH_FIXED the integer pipeline
+    with the LEDs written through the port registers, as the controller
+    runs them today. Only the chosen variant's code is linked in, so each
+    build's footprint frame is that variant's size.
+  - StatusLeds, TaskProfiler, TelemetryTx and ControlMath.h (the pot
+    mapping, band and Q8 EMA step) are symlinks into ../TemperatureController
+    (see BuildOptions.h here), and the LM19 is read through the shared
+    driver in software/libraries/LM19, so the fixed-point benchmarks call
+    the controller's own code, not copies of it. On Windows the symlinks
+    need git's core.symlinks.
+  - The clock is TaskProfiler's: Timer1 at clk/1, with its overhead taken
+    off. Each benchmark runs BENCH_ITERATIONS times per pass and the inputs
+    change every iteration, so the compiler can't fold the work away and
+    StatusLeds has a new region to show each time.
+  - Results go out of TELEMETRY_PIN at TELEMETRY_BAUD: one TELEMETRY_PROFILE
+    frame per benchmark (its BenchSlot as the slot; average = total /
+    count) and one TELEMETRY_FOOTPRINT frame, repeated every pass so a
+    receiver can join at any time. Nothing is timed while a frame is going
+    out, so the bit interrupt doesn't land in the figures; millis() and the
+    Timer1 overflow still can, which shows in the max, not the min.
+  - The LED benchmarks flicker all three LEDs, so a pass can be seen to
+    run without a receiver.
+  - Pins as on the controller board; keep them in step with
+    TemperatureController.ino.
+
+ RESULTS:
+  - None yet. No figure here has been measured: the sketch has so far only
+    been compiled, with no ATtiny84A or AVR simulator to run it on. The
+    HostSim build is no stand-in, since its mock charges no time for code.
+  - To take them: flash each BENCH_VARIANT at 8 MHz, read TELEMETRY_PIN at
+    TELEMETRY_BAUD 8N1 (frame layout in TelemetryTx.h), and fill in the
+    average (total / count) and the min of each slot, in cycles, below. Add
+    the footprint frame's flash and RAM from the same build.
+
+      benchmark                  BENCH_FLOAT     BENCH_FIXED
+      BENCH_READ_TEMP            -               -
+      BENCH_READ_SETPOINT        -               -
+      BENCH_EMA                  -               -
+      BENCH_LED_STATE            -               -
+      BENCH_LED_UPDATE           -               -
+      flash / RAM (bytes)        -               -
+
+ CHANGE LOG:
+ 2026-10-14: Initial version.
+ 2026-10-14: RESULTS section; the figures are still to be measured.
+*******************************************************************************/
+
+
+//=============================================================================
+//==== INCLUDES ===============================================================
+#include "BuildOptions.h"
+#include "AppProfile.h"
+#include "FixedTemp.h"
+#include "ControlMath.h"
+#include "FastPin.h"
+#include "StatusLeds.h"
+#include "TaskProfiler.h"
+#include "TelemetryTx.h"
+#include <LM19.h>
+
+
+//=============================================================================
+//==== GLOBALS ================================================================
+
+// ---------------- Variant ----------------------------------------------------
+#define BENCH_FLOAT 0   // float pipeline, digitalWrite() LEDs
+#define BENCH_FIXED 1   // integer pipeline, port-register LEDs
+#ifndef BENCH_VARIANT
+#define BENCH_VARIANT BENCH_FIXED
+#endif
+
+// ---------------- Pin Assignments -------------------------------------------
+const uint8_t LED_ABOVE_PIN   = PIN_PB1;  // physical pin  3 - status LED
+const uint8_t LED_INBAND_PIN  = PIN_PB2;  // physical pin  5 - status LED
+const uint8_t LED_BELOW_PIN   = PIN_PA0;  // physical pin 13 - status LED
+const uint8_t TELEMETRY_PIN   = PIN_PA2;  // physical pin 11 - serial TX out
+const uint8_t POT_PIN         = A3;       // PA3, physical pin 10 - pot wiper
+
+typedef FastPin<PortB, 1> LedAbovePin;    // LED_ABOVE_PIN  = PB1
+typedef FastPin<PortB, 2> LedInBandPin;   // LED_INBAND_PIN = PB2
+typedef FastPin<PortA, 0> LedBelowPin;    // LED_BELOW_PIN  = PA0
+typedef StatusLedPins<LedAbovePin, LedInBandPin, LedBelowPin> LedPins;
+
+typedef Lm19<7, Lm19OnVcc5V> TempSensor;  // ADC7 = PA7, physical pin 6
+
+// ---------------- Benchmark Setup -------------------------------------------
+const uint16_t BENCH_ITERATIONS = 1000;   // per benchmark per pass
+const unsigned long BENCH_PASS_MS = 5000; // a pass, then its frames, this often
+const uint32_t TELEMETRY_BAUD   = 9600;
+constexpr uint8_t TELEMETRY_BIT_TICKS = TelemetryTx::bitTicks(TELEMETRY_BAUD);
+
+enum BenchSlot : uint8_t {
+  BENCH_READ_TEMP,        // LM19 to a temperature
+  BENCH_READ_SETPOINT,    // pot to a set-point
+  BENCH_EMA,              // one filter update
+  BENCH_LED_STATE,        // StatusLeds working out the region
+  BENCH_LED_UPDATE,       // StatusLeds driving the LEDs
+  NUM_BENCH_SLOTS };
+static_assert(NUM_BENCH_SLOTS <= TaskProfiler::MAX_SLOTS,
+              "More benchmarks than TaskProfiler has slots");
+
+// ---------------- Benchmark Inputs ------------------------------------------
+// The set-point range, band and filter constant are the controller's, from
+// the TC_APP profile (see ControlMath.h).
+
+// Inputs for the StatusLeds benchmarks, one per region in turn: below the
+// band, in it either side of the set-point, and above it
+const uint8_t NUM_REGION_INPUTS = 4;
+const uint16_t REGION_COUNTS[NUM_REGION_INPUTS] = {
+  TempSensor::constPos(MID_SET_CF - HYST_CF),     TempSensor::constPos(MID_SET_CF - HYST_CF / 4),
+  TempSensor::constPos(MID_SET_CF + HYST_CF / 4), TempSensor::constPos(MID_SET_CF + HYST_CF) };
+const float REGION_TEMP_F[NUM_REGION_INPUTS] = {
+  APP.midSetF - APP.hystF,        APP.midSetF - APP.hystF / 4.0f,
+  APP.midSetF + APP.hystF / 4.0f, APP.midSetF + APP.hystF };
+
+// ---------------- Linker Symbols (avr-libc) ---------------------------------
+extern char __data_start;      // start of RAM used by .data
+extern char __data_load_end;   // end of .text + .data's image in flash
+extern char __bss_end;         // end of statically allocated RAM
+
+// ---------------- Declare Objects -------------------------------------------
+#if BENCH_VARIANT == BENCH_FIXED
+StatusLeds statusLeds(LED_ABOVE_PIN, LED_INBAND_PIN, LED_BELOW_PIN, HYST_CF);
+#else
+StatusLeds statusLeds(LED_ABOVE_PIN, LED_INBAND_PIN, LED_BELOW_PIN, APP.hystF);
+#endif
+
+// Results land here, so the compiler has to produce them
+volatile TempCF   sinkCF;
+volatile uint16_t sinkCounts;
+volatile float    sinkF;
+
+
+//=============================================================================
+//==== APPLICATION SETUP ======================================================
+
+void setup() {
+  statusLeds.begin();
+#if BENCH_VARIANT == BENCH_FIXED
+  statusLeds.setLedWriter(LedPins::write);
+#endif
+
+  telemetryTx.begin(TELEMETRY_PIN, TELEMETRY_BIT_TICKS);
+  profiler.begin();
+}
+
+
+//=============================================================================
+//==== APPLICATION MAIN LOOP ==================================================
+
+void loop() {
+  static unsigned long lastPassMs = 0 - BENCH_PASS_MS;   // first pass straight away
+  unsigned long now = millis();
+
+  if (now - lastPassMs < BENCH_PASS_MS) return;
+  lastPassMs = now;
+
+  while (!telemetryTx.isIdle()) {}   // keep the bit interrupt out of the figures
+
+  for (uint8_t slot = 0; slot < NUM_BENCH_SLOTS; slot++) {
+    profiler.reset(slot);
+  }
+  benchReadTemperature();
+  benchReadSetpoint();
+  benchEma();
+  benchLedState();
+  benchLedUpdate();
+
+  for (uint8_t slot = 0; slot < NUM_BENCH_SLOTS; slot++) {
+    sendResult(slot);
+  }
+  sendFootprint();
+}
+
+
+//=============================================================================
+//==== FUNCTIONS ==============================================================
+
+/******************************************************************************
+ PURPOSE: The LM19 read as a temperature: readTemperatureC() in the float
+  build, the clamped table position looked up in the LM19 table in the
+  fixed-point one. Both include the N_SAMPLES analogRead() calls, which are
+  most of the cost.
+*******************************************************************************/
+void benchReadTemperature() {
+  for (uint16_t i = 0; i < BENCH_ITERATIONS; i++) {
+    uint32_t start = profiler.now();
+#if BENCH_VARIANT == BENCH_FIXED
+    sinkCF = TempSensor::posToCF(TempSensor::readPos());
+#else
+    sinkF = TempSensor::readC();
+#endif
+    profiler.record(BENCH_READ_TEMP, start);
+  }
+}
+
+/******************************************************************************
+ PURPOSE: The pot read as a set-point: readSetpointF()'s float piecewise
+  map in the float build, the controller's Q16 potToSetpointCF() in the
+  fixed-point one. Both include the analogRead().
+*******************************************************************************/
+void benchReadSetpoint() {
+  for (uint16_t i = 0; i < BENCH_ITERATIONS; i++) {
+    uint32_t start = profiler.now();
+#if BENCH_VARIANT == BENCH_FIXED
+    sinkCF = potToSetpointCF(analogRead(POT_PIN));
+#else
+    sinkF = potToSetpointF(analogRead(POT_PIN));
+#endif
+    profiler.record(BENCH_READ_SETPOINT, start);
+  }
+}
+
+/******************************************************************************
+ PURPOSE: One EMA step: the float filter on °F, or the Q8 filter on LM19
+  table positions that the count-threshold build runs.
+*******************************************************************************/
+void benchEma() {
+#if BENCH_VARIANT == BENCH_FIXED
+  uint16_t filtered = TempSensor::constPos(MID_SET_CF);
+#else
+  float filtered = APP.midSetF;
+#endif
+
+  for (uint16_t i = 0; i < BENCH_ITERATIONS; i++) {
+    // A reading that swings about the filtered value
+#if BENCH_VARIANT == BENCH_FIXED
+    uint16_t raw = filtered + (i & 0x3F) - 0x20;
+#else
+    float raw = APP.midSetF + (float)((int16_t)(i & 0x3F) - 0x20) * 0.1f;
+#endif
+
+    uint32_t start = profiler.now();
+#if BENCH_VARIANT == BENCH_FIXED
+    filtered = (uint16_t)emaStepQ8(filtered, raw, TEMP_ALPHA_Q8);
+#else
+    filtered = filtered * (1.0f - APP.tempAlpha) + raw * APP.tempAlpha;
+#endif
+    profiler.record(BENCH_EMA, start);
+  }
+
+#if BENCH_VARIANT == BENCH_FIXED
+  sinkCounts = filtered;
+#else
+  sinkF = filtered;
+#endif
+}
+
+/******************************************************************************
+ PURPOSE: StatusLeds working out the region for a new temperature: the
+  float setDisplayState() every time, or the fixed-point build's
+  setCounts() against a band set up once, as the controller does.
+*******************************************************************************/
+void benchLedState() {
+#if BENCH_VARIANT == BENCH_FIXED
+  statusLeds.setBand(bandFor<TempSensor>(MID_SET_CF));
+#endif
+
+  for (uint16_t i = 0; i < BENCH_ITERATIONS; i++) {
+#if BENCH_VARIANT == BENCH_FIXED
+    uint16_t counts = REGION_COUNTS[i % NUM_REGION_INPUTS];
+#else
+    float tempF = REGION_TEMP_F[i % NUM_REGION_INPUTS];
+#endif
+
+    uint32_t start = profiler.now();
+#if BENCH_VARIANT == BENCH_FIXED
+    statusLeds.setCounts(counts);
+#else
+    statusLeds.setDisplayState(tempF, APP.midSetF);
+#endif
+    profiler.record(BENCH_LED_STATE, start);
+  }
+}
+
+/******************************************************************************
+ PURPOSE: StatusLeds driving the LEDs, through digitalWrite() or the port
+  registers. The region is moved on (untimed) before each call, so every
+  call has a new pattern to write.
+*******************************************************************************/
+void benchLedUpdate() {
+#if BENCH_VARIANT == BENCH_FIXED
+  statusLeds.setBand(bandFor<TempSensor>(MID_SET_CF));
+#endif
+
+  for (uint16_t i = 0; i < BENCH_ITERATIONS; i++) {
+#if BENCH_VARIANT == BENCH_FIXED
+    statusLeds.setCounts(REGION_COUNTS[i % NUM_REGION_INPUTS]);
+#else
+    statusLeds.setDisplayState(REGION_TEMP_F[i % NUM_REGION_INPUTS], APP.midSetF);
+#endif
+
+    uint32_t start = profiler.now();
+    statusLeds.updateLEDs();
+    profiler.record(BENCH_LED_UPDATE, start);
+  }
+  statusLeds.allOff();
+}
+
+#if BENCH_VARIANT == BENCH_FLOAT
+/******************************************************************************
+ PURPOSE: The float readSetpointF()'s map, as the controller had it: the
+  bottom half of the pot spans the minimum to the midpoint, the top half
+  the midpoint to the maximum.
+*******************************************************************************/
+float potToSetpointF(uint16_t potRaw) {
+  const float MID_RAW = 511.5;
+  float raw = potRaw;
+
+  if (raw <= MID_RAW) {
+    return APP.minSetF + (APP.midSetF - APP.minSetF) * (raw / MID_RAW);
+  } else {
+    return APP.midSetF + (APP.maxSetF - APP.midSetF) * ((raw - MID_RAW) / (1023.0f - MID_RAW));
+  }
+}
+
+#endif
+
+/******************************************************************************
+ PURPOSE: One benchmark's figures as a TELEMETRY_PROFILE frame, waiting for
+  room in the buffer.
+*******************************************************************************/
+void sendResult(uint8_t slot) {
+  const ProfileStats& stats = profiler.stats(slot);
+  TelemetryProfile frame;
+
+  frame.slot        = slot;
+  frame.count       = stats.count;
+  frame.minCycles   = stats.count ? stats.minCycles : 0;
+  frame.maxCycles   = stats.maxCycles;
+  frame.totalCycles = stats.totalCycles;
+
+  while (!telemetryTx.sendFrame(TELEMETRY_PROFILE, &frame, sizeof(frame))) {}
+}
+
+/******************************************************************************
+ PURPOSE: This build's flash and RAM, as a TELEMETRY_FOOTPRINT frame.
+
+ NOTES:
+  - The free RAM is measured from here, so it is what the deepest caller of
+    this sketch leaves; the controller's own figure has to come from its
+    own build.
+*******************************************************************************/
+void sendFootprint() {
+  char stackHere;
+  TelemetryFootprint frame;
+
+  frame.variant        = BENCH_VARIANT;
+  frame.flashBytes     = (uint16_t)(uintptr_t)&__data_load_end;
+  frame.staticRamBytes = (uint16_t)(&__bss_end - &__data_start);
+  frame.freeRamBytes   = (uint16_t)(&stackHere - &__bss_end);
+
+  while (!telemetryTx.sendFrame(TELEMETRY_FOOTPRINT, &frame, sizeof(frame))) {}
+}
@@ -0,0 +1,20 @@
+#ifndef BENCH_BUILD_OPTIONS_H
+#define BENCH_BUILD_OPTIONS_H
+
+/******************************************************************************
+ DESCRIPTION: Build options for the benchmark sketch.
+
+ NOTES:
+  - The controller modules in this folder are symlinks into
+    ../TemperatureController, so the bench times the very code that ships.
+    They include "BuildOptions.h", which here is this file: it turns on the
+    two options the bench reports through, then takes everything else from
+    the controller's own BuildOptions.h (ControllerBuildOptions.h).
+*******************************************************************************/
+
+#define TC_TELEMETRY 1          // results go out as telemetry frames
+#define TC_PROFILE   1          // Timer1 cycle counts, and room for a profile frame
+
+#include "ControllerBuildOptions.h"
+
+#endif // BENCH_BUILD_OPTIONS_H
@@ -0,0 +1 @@
+../TemperatureController/ControlMath.h
\ No newline at end of file
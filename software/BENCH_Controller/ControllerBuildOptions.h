@@ -0,0 +1 @@
+../TemperatureController/BuildOptions.h
\ No newline at end of file
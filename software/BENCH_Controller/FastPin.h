@@ -0,0 +1 @@
+../TemperatureController/FastPin.h
\ No newline at end of file
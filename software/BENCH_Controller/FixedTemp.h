@@ -0,0 +1 @@
+../TemperatureController/FixedTemp.h
\ No newline at end of file
@@ -0,0 +1 @@
+../TemperatureController/RingBuffer.h
\ No newline at end of file
@@ -0,0 +1 @@
+../TemperatureController/StatusLeds.cpp
\ No newline at end of file
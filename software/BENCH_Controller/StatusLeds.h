@@ -0,0 +1 @@
+../TemperatureController/StatusLeds.h
\ No newline at end of file
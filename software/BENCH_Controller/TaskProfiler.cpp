@@ -0,0 +1 @@
+../TemperatureController/TaskProfiler.cpp
\ No newline at end of file
@@ -0,0 +1 @@
+../TemperatureController/TaskProfiler.h
\ No newline at end of file
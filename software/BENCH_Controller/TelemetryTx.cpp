@@ -0,0 +1 @@
+../TemperatureController/TelemetryTx.cpp
\ No newline at end of file
@@ -0,0 +1 @@
+../TemperatureController/TelemetryTx.h
\ No newline at end of file
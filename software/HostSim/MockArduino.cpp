@@ -0,0 +1,413 @@
+#include <Arduino.h>
+#include <avr/sleep.h>
+#include <avr/wdt.h>
+#include <avr/eeprom.h>
+#include "SimHardware.h"
+
+/******************************************************************************
+ DESCRIPTION: The mock Arduino core and ATtiny84A peripherals behind
+  mock/Arduino.h, run against a virtual clock. See SimHardware.h for what
+  is modelled and what isn't.
+
+ NOTES:
+  - Everything happens in advanceTo(): it steps from one event (a timer
+    interrupt, the end of an ADC conversion, the harness's millisecond hook)
+    to the next, so a day of controller time costs only the events in it.
+  - The sketch's ISRs are plain functions here (see mock/avr/interrupt.h).
+    They are declared weak, so a build that leaves one out links anyway and
+    that interrupt simply has no handler.
+*******************************************************************************/
+
+// Registers (declared in mock/avr/io.h)
+#define SIM_DEFINE_REG8(name)  volatile uint8_t name;
+#define SIM_DEFINE_REG16(name) volatile uint16_t name;
+SIM_REGISTERS(SIM_DEFINE_REG8, SIM_DEFINE_REG16)
+
+extern "C" {
+  void ADC_vect(void) __attribute__((weak));
+  void TIM0_COMPB_vect(void) __attribute__((weak));
+  void TIM1_COMPA_vect(void) __attribute__((weak));
+  void TIM1_OVF_vect(void) __attribute__((weak));
+}
+
+//=============================================================================
+//==== VIRTUAL HARDWARE =======================================================
+
+static const uint64_t CYCLES_PER_MS  = F_CPU / 1000UL;
+static const uint64_t CYCLES_PER_US  = F_CPU / 1000000UL;
+static const uint64_t T0_PRESCALE    = 64;     // as ATTinyCore sets Timer0 up
+static const uint64_t T0_OVF_CYCLES  = T0_PRESCALE * 256;
+static const uint64_t NO_EVENT       = ~(uint64_t)0;
+static const uint8_t  ADC_CLOCKS     = 13;     // per conversion
+static const uint8_t  MUX_BANDGAP    = 0x21;   // 1.1 V internal reference
+static const double   BANDGAP_VOLTS  = 1.1;
+static const uint16_t EEPROM_SIZE    = E2END + 1;
+
+static uint64_t g_cycles      = 0;
+static uint64_t g_nextMsHook  = CYCLES_PER_MS;
+static uint64_t g_nextT0Ovf   = T0_OVF_CYCLES;
+
+static uint64_t g_t1Synced    = 0;     // cycle TCNT1 was last brought up to date
+static uint8_t  g_t1Clock     = 0;     // TCCR1B clock bits at that time
+
+static uint64_t g_adcDoneAt   = NO_EVENT;
+static uint8_t  g_adcMux      = 0;     // channel latched at conversion start
+static bool     g_adcInSleep  = false; // that conversion was started by sleeping
+
+static uint8_t  g_sleepMode   = SLEEP_MODE_IDLE;
+static bool     g_sleepEnable = false;
+
+static double   g_vcc         = 5.0;
+static sim::AnalogSource    g_analogSource = 0;
+static sim::MillisecondHook g_msHook       = 0;
+
+static uint64_t minEvent(uint64_t a, uint64_t b) {
+  return a < b ? a : b;
+}
+
+/******************************************************************************
+ DESCRIPTION: ADC clock divider from ADCSRA, or ATTinyCore's /64 when the
+  sketch hasn't set one.
+*******************************************************************************/
+static uint64_t adcConversionCycles() {
+  uint8_t adps = ADCSRA & (_BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0));
+  uint64_t divider = adps ? (1u << adps) : 64;
+  return divider * ADC_CLOCKS;
+}
+
+/******************************************************************************
+ DESCRIPTION: What the ADC would read on a channel right now, against the
+  reference selected in ADMUX.
+*******************************************************************************/
+static uint16_t adcCounts(uint8_t mux) {
+  double volts = 0.0;
+  if (mux == MUX_BANDGAP) {
+    volts = BANDGAP_VOLTS;
+  } else if (g_analogSource) {
+    volts = g_analogSource(mux);
+  }
+
+  double vref = (ADMUX & _BV(REFS1)) ? BANDGAP_VOLTS : g_vcc;
+  double counts = volts / vref * 1024.0;
+  if (counts < 0.0)    return 0;
+  if (counts > 1023.0) return 1023;
+  return (uint16_t)counts;
+}
+
+static void startConversion(bool inSleep) {
+  g_adcMux     = ADMUX & 0x3F;
+  g_adcDoneAt  = g_cycles + adcConversionCycles();
+  g_adcInSleep = inSleep;
+}
+
+/******************************************************************************
+ DESCRIPTION: Timer1 prescaler from its clock-select bits (0 = stopped).
+  External clocking isn't modelled and counts as stopped.
+*******************************************************************************/
+static uint64_t timer1Prescale() {
+  static const uint16_t PRESCALE[8] = { 0, 1, 8, 64, 256, 1024, 0, 0 };
+  return PRESCALE[TCCR1B & (_BV(CS12) | _BV(CS11) | _BV(CS10))];
+}
+
+static bool timer1Ctc() {
+  return (TCCR1B & _BV(WGM12)) && !(TCCR1B & _BV(WGM13));
+}
+
+static bool timer1Normal() {
+  return !(TCCR1B & (_BV(WGM13) | _BV(WGM12))) && !(TCCR1A & (_BV(WGM11) | _BV(WGM10)));
+}
+
+/******************************************************************************
+ DESCRIPTION: Bring TCNT1 (and TCNT0) up to the current cycle.
+
+ NOTES:
+  - A change to Timer1's clock bits starts the count from now, which is
+    what starting or stopping the timer looks like to the sketch.
+*******************************************************************************/
+static void syncTimers() {
+  TCNT0 = (uint8_t)(g_cycles / T0_PRESCALE);
+
+  uint8_t clock = TCCR1B & 0x07;
+  uint64_t prescale = timer1Prescale();
+  if (clock != g_t1Clock || prescale == 0) {
+    g_t1Clock  = clock;
+    g_t1Synced = g_cycles;
+    return;
+  }
+  uint64_t ticks = (g_cycles - g_t1Synced) / prescale;
+  TCNT1      = (uint16_t)(TCNT1 + ticks);
+  g_t1Synced += ticks * prescale;
+}
+
+/******************************************************************************
+ DESCRIPTION: When the next Timer1 compare A interrupt (CTC mode), Timer1
+  overflow interrupt (normal mode) and Timer0 compare B interrupt are due,
+  or NO_EVENT.
+*******************************************************************************/
+static uint64_t nextTimer1CompareA() {
+  uint64_t prescale = timer1Prescale();
+  if (prescale == 0 || !timer1Ctc() || !(TIMSK1 & _BV(OCIE1A))) return NO_EVENT;
+
+  // In CTC mode the counter clears on the tick after it matches OCR1A
+  uint32_t ticks = (uint16_t)(OCR1A + 1 - TCNT1);
+  if (ticks == 0) ticks = 0x10000;
+  return g_t1Synced + ticks * prescale;
+}
+
+static uint64_t nextTimer1Overflow() {
+  uint64_t prescale = timer1Prescale();
+  if (prescale == 0 || !timer1Normal() || !(TIMSK1 & _BV(TOIE1))) return NO_EVENT;
+
+  return g_t1Synced + (0x10000 - (uint32_t)TCNT1) * prescale;
+}
+
+static uint64_t nextTimer0CompareB() {
+  if (!(TIMSK0 & _BV(OCIE0B))) return NO_EVENT;
+
+  uint64_t tick = g_cycles / T0_PRESCALE;
+  uint32_t ticks = (uint8_t)(OCR0B - (uint8_t)tick);
+  if (ticks == 0) ticks = 256;
+  return (tick + ticks) * T0_PRESCALE;
+}
+
+/******************************************************************************
+ DESCRIPTION: Run the virtual hardware up to targetCycles.
+
+ NOTES:
+  - With wakeOnInterrupt it stops early, right after the first interrupt
+    that ran a handler (or the Timer0 overflow, which always does on the
+    real part: it keeps millis()). That is how sleep_cpu() returns.
+  - Returns true if it stopped for an interrupt.
+*******************************************************************************/
+static bool advanceTo(uint64_t targetCycles, bool wakeOnInterrupt) {
+  while (g_cycles < targetCycles) {
+    syncTimers();
+    const uint64_t t1Event = nextTimer1CompareA();
+    const uint64_t t1Ovf   = nextTimer1Overflow();
+    const uint64_t t0Event = nextTimer0CompareB();
+
+    uint64_t t = minEvent(targetCycles, g_nextMsHook);
+    t = minEvent(t, g_nextT0Ovf);
+    t = minEvent(t, g_adcDoneAt);
+    t = minEvent(t, t1Event);
+    t = minEvent(t, t1Ovf);
+    t = minEvent(t, t0Event);
+
+    g_cycles = t;
+    syncTimers();
+    bool interrupted = false;
+
+    if (t == g_adcDoneAt) {
+      g_adcDoneAt = NO_EVENT;
+      ADC = adcCounts(g_adcMux);
+      if ((ADCSRA & _BV(ADIE)) && ADC_vect) {
+        ADC_vect();
+        interrupted = true;
+      }
+    }
+    if (t == t1Event) {
+      TCNT1      = 0;
+      g_t1Synced = t;
+      if (TIM1_COMPA_vect) TIM1_COMPA_vect();
+      interrupted = true;
+    }
+    if (t == t1Ovf) {
+      TCNT1      = 0;
+      g_t1Synced = t;
+      if (TIM1_OVF_vect) TIM1_OVF_vect();
+      interrupted = true;
+    }
+    if (t == t0Event) {
+      if (TIM0_COMPB_vect) TIM0_COMPB_vect();
+      interrupted = true;
+    }
+    if (t == g_nextT0Ovf) {
+      g_nextT0Ovf += T0_OVF_CYCLES;
+      const bool autoTrigger = (ADCSRA & _BV(ADEN)) && (ADCSRA & _BV(ADATE)) &&
+                               (ADCSRB & 0x07) == _BV(ADTS2);
+      if (autoTrigger && g_adcDoneAt == NO_EVENT) startConversion(false);
+      interrupted = true;   // the millis() tick
+    }
+    if (t == g_nextMsHook) {
+      g_nextMsHook += CYCLES_PER_MS;
+      if (g_msHook) g_msHook();
+    }
+
+    if (wakeOnInterrupt && interrupted) return true;
+  }
+  return false;
+}
+
+//=============================================================================
+//==== HARNESS INTERFACE (SimHardware.h) ======================================
+
+namespace sim {
+
+void setAnalogSource(AnalogSource source) { g_analogSource = source; }
+void setMillisecondHook(MillisecondHook hook) { g_msHook = hook; }
+void setSupplyVolts(double vcc) { g_vcc = vcc; }
+
+uint64_t cycles() { return g_cycles; }
+double seconds() { return (double)g_cycles / F_CPU; }
+
+void advanceUs(uint32_t us) {
+  advanceTo(g_cycles + us * CYCLES_PER_US, false);
+}
+
+bool pinOutput(uint8_t pin) {
+  volatile uint8_t* port = portOutputRegister(digitalPinToPort(pin));
+  return (*port & digitalPinToBitMask(pin)) != 0;
+}
+
+} // namespace sim
+
+//=============================================================================
+//==== ARDUINO CORE ===========================================================
+
+unsigned long millis() { return (unsigned long)(g_cycles / CYCLES_PER_MS); }
+unsigned long micros() { return (unsigned long)(g_cycles / CYCLES_PER_US); }
+
+void delay(unsigned long ms) {
+  advanceTo(g_cycles + ms * CYCLES_PER_MS, false);
+}
+
+void delayMicroseconds(unsigned int us) {
+  advanceTo(g_cycles + us * CYCLES_PER_US, false);
+}
+
+// ---------------- Pins (ATTinyCore ATtiny84 numbering) ----------------------
+static const uint8_t PORT_A = 1;
+static const uint8_t PORT_B = 2;
+static const uint8_t PORT_B_BITS[4] = { 2, 1, 0, 3 };   // pins 8..11
+
+uint8_t digitalPinToPort(uint8_t pin) {
+  return pin < 8 ? PORT_A : PORT_B;
+}
+
+uint8_t digitalPinToBitMask(uint8_t pin) {
+  return pin < 8 ? _BV(pin) : _BV(PORT_B_BITS[(pin - 8) & 0x03]);
+}
+
+volatile uint8_t* portOutputRegister(uint8_t port) { return port == PORT_A ? &PORTA : &PORTB; }
+volatile uint8_t* portInputRegister(uint8_t port)  { return port == PORT_A ? &PINA : &PINB; }
+volatile uint8_t* portModeRegister(uint8_t port)   { return port == PORT_A ? &DDRA : &DDRB; }
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  const uint8_t port = digitalPinToPort(pin);
+  const uint8_t mask = digitalPinToBitMask(pin);
+  volatile uint8_t* ddr = portModeRegister(port);
+  volatile uint8_t* out = portOutputRegister(port);
+
+  if (mode == OUTPUT) {
+    *ddr |= mask;
+  } else {
+    *ddr &= (uint8_t)~mask;
+    if (mode == INPUT_PULLUP) *out |= mask;
+    else                      *out &= (uint8_t)~mask;
+  }
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+  volatile uint8_t* out = portOutputRegister(digitalPinToPort(pin));
+  if (value) *out |= digitalPinToBitMask(pin);
+  else       *out &= (uint8_t)~digitalPinToBitMask(pin);
+}
+
+int digitalRead(uint8_t pin) {
+  const uint8_t port = digitalPinToPort(pin);
+  const uint8_t mask = digitalPinToBitMask(pin);
+  volatile uint8_t* reg = (*portModeRegister(port) & mask) ? portOutputRegister(port)
+                                                           : portInputRegister(port);
+  return (*reg & mask) ? HIGH : LOW;
+}
+
+// ---------------- ADC -------------------------------------------------------
+void analogReference(uint8_t mode) {
+  uint8_t refs = mode == INTERNAL1V1 ? _BV(REFS1) : (mode == EXTERNAL ? _BV(REFS0) : 0);
+  ADMUX = (ADMUX & ~(_BV(REFS1) | _BV(REFS0))) | refs;
+}
+
+int analogRead(uint8_t pin) {
+  ADMUX = (ADMUX & ~0x3F) | (pin & 0x3F);
+  startConversion(false);
+  advanceTo(g_adcDoneAt, false);   // finishes the conversion into ADC
+  return ADC;
+}
+
+//=============================================================================
+//==== AVR-LIBC ===============================================================
+
+// ---------------- Sleep -----------------------------------------------------
+void set_sleep_mode(uint8_t mode) { g_sleepMode = mode; }
+void sleep_enable()  { g_sleepEnable = true; }
+void sleep_disable() { g_sleepEnable = false; }
+
+/******************************************************************************
+ DESCRIPTION: Sleep until the next interrupt. Entering ADC Noise Reduction
+  sleep with the ADC on starts a conversion, as on the real part.
+
+ NOTES:
+  - ADSC is never shown as set, so a sketch that waits for a background
+    conversion to finish before sleeping doesn't wait at all. That
+    conversion is dropped here, as if it had finished with its interrupt
+    off, and the new one starts on the current channel.
+  - Going back to sleep after some other interrupt woke us leaves the
+    conversion the last sleep started running, as on the real part.
+*******************************************************************************/
+void sleep_cpu() {
+  if (!g_sleepEnable) return;
+  if (g_sleepMode == SLEEP_MODE_ADC && (ADCSRA & _BV(ADEN)) &&
+      !(g_adcInSleep && g_adcDoneAt != NO_EVENT)) {
+    startConversion(true);
+  }
+  advanceTo(NO_EVENT, true);
+}
+
+// ---------------- Watchdog (only the reset-timer calls are used) ------------
+void wdt_enable(uint8_t) {}
+void wdt_disable() {}
+void wdt_reset() {}
+
+// ---------------- EEPROM ----------------------------------------------------
+static uint8_t* eepromMemory() {
+  static uint8_t memory[EEPROM_SIZE];
+  static bool erased = (memset(memory, 0xFF, sizeof(memory)), true);
+  (void)erased;
+  return memory;
+}
+
+static uint16_t eepromIndex(const void* addr) {
+  return (uint16_t)((uintptr_t)addr % EEPROM_SIZE);
+}
+
+uint8_t eeprom_read_byte(const uint8_t* addr) {
+  return eepromMemory()[eepromIndex(addr)];
+}
+
+void eeprom_write_byte(uint8_t* addr, uint8_t value) {
+  eepromMemory()[eepromIndex(addr)] = value;
+}
+
+void eeprom_update_byte(uint8_t* addr, uint8_t value) {
+  eeprom_write_byte(addr, value);
+}
+
+void eeprom_read_block(void* dst, const void* src, size_t n) {
+  uint8_t* out = (uint8_t*)dst;
+  for (size_t i = 0; i < n; i++) {
+    out[i] = eepromMemory()[(eepromIndex(src) + i) % EEPROM_SIZE];
+  }
+}
+
+void eeprom_update_block(const void* src, void* dst, size_t n) {
+  const uint8_t* in = (const uint8_t*)src;
+  for (size_t i = 0; i < n; i++) {
+    eepromMemory()[(eepromIndex(dst) + i) % EEPROM_SIZE] = in[i];
+  }
+}
+
+uint8_t eeprom_is_ready() { return 1; }
+
+namespace sim {
+uint8_t eepromByte(uint16_t addr) { return eepromMemory()[addr % EEPROM_SIZE]; }
+}
@@ -0,0 +1,54 @@
+#ifndef SIM_HARDWARE_H
+#define SIM_HARDWARE_H
+
+#include <stdint.h>
+
+/******************************************************************************
+ DESCRIPTION: The harness's side of the mock Arduino core (MockArduino.cpp):
+  the virtual clock, and the hooks through which the simulated world feeds
+  the ADC and watches the pins.
+
+ NOTES:
+  - Time is counted in CPU cycles of a virtual F_CPU clock. It only moves
+    when the sketch waits (delay(), the sleep calls, analogRead()) or the
+    harness calls advanceUs(); tasks themselves take no time.
+  - What is modelled, because the sketch depends on it:
+      * Timer0 at clk/64. Its overflow paces millis() on the real part and
+        auto-triggers the ADC (TC_ADC_INTERRUPT); its compare B interrupt
+        clocks TelemetryTx.
+      * Timer1 in CTC mode with the compare A interrupt
+        (TimeProportionalOutput), and in normal mode with the overflow
+        interrupt (TaskProfiler), at any prescaler.
+      * The ADC: analogRead(), auto-triggered conversions and conversions
+        in ADC Noise Reduction sleep, each taking 13 ADC clocks.
+      * Idle and ADC Noise Reduction sleep: sleep_cpu() returns at the next
+        interrupt.
+      * EEPROM, as an array that starts erased.
+  - Not modelled: the other Timer1 modes, pin-change interrupts and power-down
+    sleep, so TC_OUTPUT_PHASE_ANGLE and TC_SLEEP_POWER_DOWN builds are
+    refused (see SimMain.cpp).
+*******************************************************************************/
+
+namespace sim {
+
+// Volts on an ADC channel (the MUX number) right now.
+typedef double (*AnalogSource)(uint8_t mux);
+
+// Called once per simulated millisecond, after the sketch's own interrupts
+// for that instant; this is where the plant is stepped.
+typedef void (*MillisecondHook)();
+
+void setAnalogSource(AnalogSource source);
+void setMillisecondHook(MillisecondHook hook);
+void setSupplyVolts(double vcc);
+
+uint64_t cycles();             // virtual CPU cycles since reset
+double   seconds();
+void     advanceUs(uint32_t us);
+
+bool    pinOutput(uint8_t pin);    // level the sketch drives on a pin
+uint8_t eepromByte(uint16_t addr);
+
+} // namespace sim
+
+#endif // SIM_HARDWARE_H
@@ -0,0 +1,459 @@
+/******************************************************************************
+ DESCRIPTION: Host simulation of the Temperature Controller. Runs the real
+  sketch (setup(), loop(), every task and class) against the mock core in
+  mock/ and a thermal model of the box, much faster than real time, and
+  reports how well it held the set-point.
+
+ NOTES:
+  - Build and run it with the Makefile here; see readme.md.
+  - The heater is whatever drives SSR_PIN (PB0); the plant sees it once a
+    millisecond. The LM19 is fed the plant temperature through its
+    datasheet transfer curve plus Gaussian noise, and the pot is parked
+    wherever gives the requested set-point.
+  - Metrics are worked out from the true plant temperature, not from what
+    the controller thinks it is, and only from the end of any autotune run.
+*******************************************************************************/
+
+#include <Arduino.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <random>
+#include <vector>
+#include "BuildOptions.h"
+#include "AppProfile.h"
+#include "SimHardware.h"
+#include "ThermalPlant.h"
+#include "IdleSleep.h"
+#if TC_AUTOTUNE
+#include "PidController.h"
+#include "RelayAutotune.h"
+#endif
+#if TC_PREDICTIVE_CUTOFF
+#include "OvershootPredictor.h"
+#endif
+
+#if TC_OUTPUT_MODE == TC_OUTPUT_PHASE_ANGLE
+#error "The simulation doesn't model mains zero-crossings (TC_OUTPUT_PHASE_ANGLE)"
+#endif
+#if TC_IDLE_SLEEP == TC_SLEEP_POWER_DOWN
+#error "The simulation doesn't model power-down sleep (TC_SLEEP_POWER_DOWN)"
+#endif
+
+#ifndef SIM_CONFIG
+#define SIM_CONFIG "custom"
+#endif
+
+// The sketch
+void setup();
+void loop();
+extern IdleSleep idleSleep;
+#if TC_AUTOTUNE
+extern PidController pid;
+extern RelayAutotune autotune;
+#endif
+#if TC_PREDICTIVE_CUTOFF
+extern OvershootPredictor overshoot;
+#endif
+
+// ---------------- Wiring, as on the board -----------------------------------
+const uint8_t SSR_PIN    = PIN_PB0;
+const uint8_t TEMP_MUX   = 7;    // ADC7, LM19
+const uint8_t POT_MUX    = 3;    // ADC3, pot wiper
+#if TC_ZONES == 2
+const uint8_t ZONE2_SSR_PIN  = PIN_PA5;
+const uint8_t ZONE2_TEMP_MUX = 6;    // ADC6, second zone's LM19
+#endif
+
+// LM19 output divider (TC_ADC_INTERNAL_REF); keep in step with LM19
+// Constants in the sketch.
+#if TC_ADC_INTERNAL_REF
+const double LM19_DIVIDER = 100.0 / (82.0 + 100.0);
+#else
+const double LM19_DIVIDER = 1.0;
+#endif
+
+// The pot's set-point mapping, from the same TC_APP profile as the sketch.
+const double MIN_SET_F = APP.minSetF;
+const double MID_SET_F = APP.midSetF;
+const double MAX_SET_F = APP.maxSetF;
+
+const uint16_t POT_FULL_UP = 1023;
+
+//=============================================================================
+//==== OPTIONS ================================================================
+
+struct Options {
+  double days       = 1.0;
+  double setPointF  = APP.midSetF;
+  double ambientF   = 60.0;
+  double gainF      = 40.0;    // full-power rise above ambient
+  double tauS       = 900.0;
+  double deadS      = 20.0;
+  double noiseMv    = 1.0;     // LM19 + ADC noise, RMS
+  double vcc        = 5.0;
+  double droopMv    = 0.0;     // supply sag per SSR that is on
+  double bandF      = 1.0;     // settling band, +/-
+  bool   autotune   = false;
+  double openAtS    = -1.0;    // LM19 goes open circuit here; < 0 never
+  unsigned seed     = 1;
+  const char* csvPath = 0;
+  double csvEveryS  = 10.0;
+};
+
+static void usage(const char* prog) {
+  printf("usage: %s [options]\n"
+         "  --days D        simulated time (1)\n"
+         "  --setpoint F    pot set to this set-point, degF (mid-pot)\n"
+         "  --ambient F     room temperature, degF (60)\n"
+         "  --gain F        rise above ambient at full power, degF (40)\n"
+         "  --tau S         box time constant, s (900)\n"
+         "  --dead S        dead time, heater to sensor, s (20)\n"
+         "  --noise MV      sensor noise, mV RMS (1.0)\n"
+         "  --vcc V         supply and ADC reference, V (5.0)\n"
+         "  --droop MV      supply sag per SSR on, mV; rings 3x that for 10 ms\n"
+         "                  after each edge (0)\n"
+         "  --band F        settling band, +/- degF (1.0)\n"
+         "  --autotune      boot with the pot fully up (TC_AUTOTUNE builds)\n"
+         "  --open-at S     LM19 wire breaks S s in; its pin floats up to Vcc\n"
+         "  --seed N        noise seed (1)\n"
+         "  --csv FILE      write a trace: time, temperature, heater\n"
+         "  --csv-every S   trace interval, s (10)\n", prog);
+}
+
+static bool parseOptions(int argc, char** argv, Options& opt) {
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    const char* val = (i + 1 < argc) ? argv[i + 1] : 0;
+
+    if (!strcmp(arg, "--autotune")) { opt.autotune = true; continue; }
+    if (!val) return false;
+    if      (!strcmp(arg, "--days"))      opt.days      = atof(val);
+    else if (!strcmp(arg, "--setpoint"))  opt.setPointF = atof(val);
+    else if (!strcmp(arg, "--ambient"))   opt.ambientF  = atof(val);
+    else if (!strcmp(arg, "--gain"))      opt.gainF     = atof(val);
+    else if (!strcmp(arg, "--tau"))       opt.tauS      = atof(val);
+    else if (!strcmp(arg, "--dead"))      opt.deadS     = atof(val);
+    else if (!strcmp(arg, "--noise"))     opt.noiseMv   = atof(val);
+    else if (!strcmp(arg, "--vcc"))       opt.vcc       = atof(val);
+    else if (!strcmp(arg, "--droop"))     opt.droopMv   = atof(val);
+    else if (!strcmp(arg, "--band"))      opt.bandF     = atof(val);
+    else if (!strcmp(arg, "--open-at"))   opt.openAtS   = atof(val);
+    else if (!strcmp(arg, "--seed"))      opt.seed      = (unsigned)atoi(val);
+    else if (!strcmp(arg, "--csv"))       opt.csvPath   = val;
+    else if (!strcmp(arg, "--csv-every")) opt.csvEveryS = atof(val);
+    else return false;
+    i++;
+  }
+  return opt.days > 0.0 && opt.tauS > 0.0 && opt.deadS >= 0.0 && opt.csvEveryS > 0.0 &&
+         opt.droopMv >= 0.0;
+}
+
+//=============================================================================
+//==== THE WORLD AROUND THE CHIP ==============================================
+
+static Options g_opt;
+static ThermalPlant* g_plant = 0;
+static std::mt19937 g_rng;
+static std::normal_distribution<double> g_noise(0.0, 1.0);
+static double g_potVolts = 0.0;
+#if TC_ZONES == 2
+// The second zone: a box of its own, just like the first
+static ThermalPlant* g_plant2 = 0;
+static bool     g_heater2WasOn = false;
+static uint64_t g_switches2    = 0;
+static std::vector<float> g_zone2PerS;
+#endif
+
+static bool     g_heaterWasOn = false;
+static uint64_t g_switches    = 0;
+static uint64_t g_heaterOnMs  = 0;
+static uint32_t g_ms          = 0;
+static uint64_t g_lm19Reads   = 0;
+static uint64_t g_lastOnAfterOpenMs = 0;   // --open-at: last heater-on ms after the break
+static double   g_ringVolts   = 0.0;   // --droop: the supply's ring after the last edge...
+static uint32_t g_ringUntilMs = 0;     // ...until here
+
+static std::vector<float> g_tempPerS;     // plant temperature, once a second
+static std::vector<uint16_t> g_onMsPerS;  // heater on-time in each second
+static std::vector<uint16_t> g_readsPerS; // LM19 conversions in each second
+static std::vector<uint16_t> g_awakePerS; // IdleSleep's duty, once a second
+static FILE* g_csv = 0;
+
+/******************************************************************************
+ DESCRIPTION: LM19 output for a temperature, from the datasheet's parabolic
+  fit (the sketch uses the straight-line approximation).
+*******************************************************************************/
+static double lm19Volts(double tempF) {
+  double tempC = (tempF - 32.0) * 5.0 / 9.0;
+  return -3.88e-6 * tempC * tempC - 1.15e-2 * tempC + 1.8639;
+}
+
+/******************************************************************************
+ DESCRIPTION: Pot reading (0..1023) that the sketch maps to setPointF.
+*******************************************************************************/
+static double potRawFor(double setPointF) {
+  const double MID_RAW = 511.5;
+  double raw = setPointF <= MID_SET_F
+             ? (setPointF - MIN_SET_F) / (MID_SET_F - MIN_SET_F) * MID_RAW
+             : MID_RAW + (setPointF - MID_SET_F) / (MAX_SET_F - MID_SET_F) * MID_RAW;
+  return raw < 0.0 ? 0.0 : (raw > 1023.0 ? 1023.0 : raw);
+}
+
+static void setPot(double raw) {
+  g_potVolts = (raw + 0.5) / 1024.0 * g_opt.vcc;   // middle of that count
+}
+
+static bool lm19Open() {
+  return g_opt.openAtS >= 0.0 && g_ms >= (uint32_t)(g_opt.openAtS * 1000.0);
+}
+
+static double analogSource(uint8_t mux) {
+  if (mux == TEMP_MUX) {
+    g_lm19Reads++;
+    if (lm19Open()) return g_opt.vcc;
+    double volts = lm19Volts(g_plant->temperatureF()) + g_noise(g_rng) * g_opt.noiseMv / 1000.0;
+    return volts * LM19_DIVIDER;
+  }
+  if (mux == POT_MUX) return g_potVolts;
+#if TC_ZONES == 2
+  if (mux == ZONE2_TEMP_MUX) {
+    double volts = lm19Volts(g_plant2->temperatureF()) + g_noise(g_rng) * g_opt.noiseMv / 1000.0;
+    return volts * LM19_DIVIDER;
+  }
+#endif
+  return 0.0;
+}
+
+/******************************************************************************
+ DESCRIPTION: --droop: the supply, given how many SSRs are on and that one
+  just switched (on = +1, off = -1, none = 0). The step in load sags it by
+  droopMv a heater, and each edge rings over the new level for 10 ms.
+*******************************************************************************/
+static void updateSupply(int ssrsOn, int edge) {
+  const uint32_t RING_MS = 10;
+  const double droop = g_opt.droopMv / 1000.0;
+  if (droop == 0.0) return;
+
+  if (edge != 0) {
+    g_ringVolts   = -3.0 * droop * edge;
+    g_ringUntilMs = g_ms + RING_MS;
+  }
+  double vcc = g_opt.vcc - droop * ssrsOn;
+  if (g_ms < g_ringUntilMs) vcc += g_ringVolts;
+  sim::setSupplyVolts(vcc);
+}
+
+/******************************************************************************
+ DESCRIPTION: Once a simulated millisecond: step the plant with the heater
+  as the sketch left it, and keep the books.
+*******************************************************************************/
+static void onMillisecond() {
+  bool heaterOn = sim::pinOutput(SSR_PIN);
+  int ssrsOn = heaterOn ? 1 : 0;
+  int edge   = heaterOn == g_heaterWasOn ? 0 : (heaterOn ? 1 : -1);
+  if (heaterOn != g_heaterWasOn) g_switches++;
+  g_heaterWasOn = heaterOn;
+  if (heaterOn) g_heaterOnMs++;
+  if (heaterOn && lm19Open()) g_lastOnAfterOpenMs = g_ms;
+
+  g_plant->step(heaterOn ? 1.0 : 0.0);
+#if TC_ZONES == 2
+  bool heater2On = sim::pinOutput(ZONE2_SSR_PIN);
+  ssrsOn += heater2On ? 1 : 0;
+  if (heater2On != g_heater2WasOn) {
+    g_switches2++;
+    edge = heater2On ? 1 : -1;
+  }
+  g_heater2WasOn = heater2On;
+  g_plant2->step(heater2On ? 1.0 : 0.0);
+  if ((g_ms + 1) % 1000 == 0) g_zone2PerS.push_back((float)g_plant2->temperatureF());
+#endif
+  updateSupply(ssrsOn, edge);
+  g_ms++;
+
+  if (g_ms % 1000 == 0) {
+    g_tempPerS.push_back((float)g_plant->temperatureF());
+    static uint64_t lastOnMs = 0;
+    g_onMsPerS.push_back((uint16_t)(g_heaterOnMs - lastOnMs));
+    lastOnMs = g_heaterOnMs;
+    static uint64_t lastReads = 0;
+    g_readsPerS.push_back((uint16_t)(g_lm19Reads - lastReads));
+    lastReads = g_lm19Reads;
+    g_awakePerS.push_back(idleSleep.dutyPermille());
+  }
+  if (g_csv && g_ms % (uint32_t)(g_opt.csvEveryS * 1000.0) == 0) {
+    fprintf(g_csv, "%.1f,%.3f,%d\n", g_ms / 1000.0, g_plant->temperatureF(), heaterOn ? 1 : 0);
+  }
+}
+
+//=============================================================================
+//==== METRICS ================================================================
+
+static void report(size_t fromS, uint64_t switchesAtStart, double wallS) {
+  const double sp   = g_opt.setPointF;
+  const double band = g_opt.bandF;
+  const size_t endS = g_tempPerS.size();
+  const size_t n    = endS - fromS;
+
+  printf("config        : %s\n", SIM_CONFIG);
+  printf("plant         : ambient %.1f F, gain %.1f F, tau %.0f s, dead time %.0f s, noise %.1f mV\n",
+         g_opt.ambientF, g_opt.gainF, g_opt.tauS, g_opt.deadS, g_opt.noiseMv);
+  printf("set-point     : %.2f F\n", sp);
+  printf("simulated     : %.2f days in %.2f s (%.0fx real time)\n",
+         endS / 86400.0, wallS, wallS > 0.0 ? endS / wallS : 0.0);
+  if (n < 4) {
+    printf("too short to measure\n");
+    return;
+  }
+
+  // Rise: first time within the band below the set-point
+  size_t riseS = endS;
+  for (size_t s = fromS; s < endS; s++) {
+    if (g_tempPerS[s] >= sp - band) { riseS = s; break; }
+  }
+
+  // Overshoot: highest point after first reaching the set-point
+  double peak = -1e9;
+  bool reached = false;
+  for (size_t s = fromS; s < endS; s++) {
+    if (g_tempPerS[s] >= sp) reached = true;
+    if (reached && g_tempPerS[s] > peak) peak = g_tempPerS[s];
+  }
+
+  // Settling: the last time it was outside the band
+  size_t lastOutS = fromS;
+  bool everOut = false;
+  for (size_t s = fromS; s < endS; s++) {
+    if (fabs(g_tempPerS[s] - sp) > band) { lastOutS = s; everOut = true; }
+  }
+
+  // Steady state: the last quarter of the run
+  const size_t steadyFrom = endS - n / 4;
+  double sum = 0.0, sumSq = 0.0, lo = 1e9, hi = -1e9;
+  uint64_t onMs = 0, reads = 0, awake = 0;
+  for (size_t s = steadyFrom; s < endS; s++) {
+    double t = g_tempPerS[s];
+    sum   += t;
+    sumSq += (t - sp) * (t - sp);
+    if (t < lo) lo = t;
+    if (t > hi) hi = t;
+    onMs  += g_onMsPerS[s];
+    reads += g_readsPerS[s];
+    awake += g_awakePerS[s];
+  }
+  const size_t steadyN = endS - steadyFrom;
+  const double hours   = n / 3600.0;
+  const uint64_t switches = g_switches - switchesAtStart;
+
+  if (riseS < endS) printf("rise time     : %zu s (to %.1f F below)\n", riseS - fromS, band);
+  else              printf("rise time     : never got within %.1f F\n", band);
+  if (reached)      printf("overshoot     : %.2f F\n", peak - sp);
+  else              printf("overshoot     : never reached the set-point\n");
+  if (!everOut)                printf("settling time : 0 s (always within +/- %.1f F)\n", band);
+  else if (lastOutS + 1 < endS) printf("settling time : %zu s (within +/- %.1f F)\n", lastOutS + 1 - fromS, band);
+  else                         printf("settling time : not settled within +/- %.1f F\n", band);
+  printf("steady state  : mean %.2f F, swing %.2f F p-p, rms error %.2f F (last %.1f h)\n",
+         sum / steadyN, hi - lo, sqrt(sumSq / steadyN), steadyN / 3600.0);
+  printf("heater        : %.1f %% on at steady state, %llu SSR switches (%.1f per hour)\n",
+         100.0 * onMs / (steadyN * 1000.0), (unsigned long long)switches, switches / hours);
+  printf("LM19          : %.0f conversions per minute, %.0f at steady state\n",
+         g_lm19Reads / (endS / 60.0), reads / (steadyN / 60.0));
+  printf("CPU           : awake %.2f %% at steady state (IdleSleep::dutyPermille())\n",
+         awake / (steadyN * 10.0));
+
+#if TC_ZONES == 2
+  // Same steady-state window, for the second zone
+  double sum2 = 0.0, lo2 = 1e9, hi2 = -1e9;
+  for (size_t s = steadyFrom; s < endS && s < g_zone2PerS.size(); s++) {
+    double t = g_zone2PerS[s];
+    sum2 += t;
+    if (t < lo2) lo2 = t;
+    if (t > hi2) hi2 = t;
+  }
+  printf("zone 2        : mean %.2f F, swing %.2f F p-p at steady state, %llu SSR switches\n",
+         sum2 / steadyN, hi2 - lo2, (unsigned long long)g_switches2);
+#endif
+}
+
+//=============================================================================
+//==== MAIN ===================================================================
+
+int main(int argc, char** argv) {
+  if (!parseOptions(argc, argv, g_opt)) {
+    usage(argv[0]);
+    return 2;
+  }
+#if !TC_AUTOTUNE
+  if (g_opt.autotune) {
+    fprintf(stderr, "--autotune needs a TC_AUTOTUNE build (CONFIG=autotune)\n");
+    return 2;
+  }
+#endif
+
+  ThermalPlant plant(g_opt.ambientF, g_opt.gainF, g_opt.tauS, g_opt.deadS, 0.001);
+  g_plant = &plant;
+#if TC_ZONES == 2
+  ThermalPlant plant2(g_opt.ambientF, g_opt.gainF, g_opt.tauS, g_opt.deadS, 0.001);
+  g_plant2 = &plant2;
+#endif
+  g_rng.seed(g_opt.seed);
+  if (g_opt.csvPath) {
+    g_csv = fopen(g_opt.csvPath, "w");
+    if (!g_csv) { perror(g_opt.csvPath); return 1; }
+    fprintf(g_csv, "time_s,temp_f,heater\n");
+  }
+
+  sim::setSupplyVolts(g_opt.vcc);
+  sim::setAnalogSource(analogSource);
+  sim::setMillisecondHook(onMillisecond);
+
+  // Power on. An autotune is asked for by the pot being fully up at boot;
+  // it is turned to the working set-point straight after.
+  setPot(g_opt.autotune ? POT_FULL_UP : potRawFor(g_opt.setPointF));
+  setup();
+  setPot(potRawFor(g_opt.setPointF));
+
+  const uint64_t endMs = (uint64_t)(g_opt.days * 86400.0 * 1000.0);
+  size_t fromS = 0;
+  uint64_t switchesAtStart = 0;
+#if TC_AUTOTUNE
+  bool tuning = g_opt.autotune;
+#endif
+
+  clock_t wallStart = clock();
+  while (g_ms < endMs) {
+    loop();
+#if TC_AUTOTUNE
+    if (tuning && !autotune.isRunning()) {
+      tuning = false;
+      fromS = g_tempPerS.size();
+      switchesAtStart = g_switches;
+      const PidGains& gains = pid.gains();
+      printf("autotune      : %s after %.0f s, kpQ8 %u, kiQ16 %u, kdQ8 %u\n",
+             autotune.hasFailed() ? "FAILED" : "done", sim::seconds(),
+             gains.kpQ8, gains.kiQ16, gains.kdQ8);
+    }
+#endif
+  }
+  double wallS = (double)(clock() - wallStart) / CLOCKS_PER_SEC;
+
+  if (g_csv) fclose(g_csv);
+#if TC_PREDICTIVE_CUTOFF
+  const OvershootLeads& leads = overshoot.leads();
+  printf("coast leads   : %.1f after off, %.1f after on (control periods)\n",
+         leads.offQ4 / 16.0, leads.onQ4 / 16.0);
+#endif
+  report(fromS, switchesAtStart, wallS);
+  if (g_opt.openAtS >= 0.0) {
+    const uint32_t openMs = (uint32_t)(g_opt.openAtS * 1000.0);
+    if (g_lastOnAfterOpenMs == 0) {
+      printf("open LM19     : heater off from the break at %.0f s\n", g_opt.openAtS);
+    } else {
+      printf("open LM19     : heater last on %llu ms after the break at %.0f s\n",
+             (unsigned long long)(g_lastOnAfterOpenMs + 1 - openMs), g_opt.openAtS);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,34 @@
+#include "ThermalPlant.h"
+#include <math.h>
+
+/******************************************************************************
+ DESCRIPTION: Constructor. The box starts at ambient, with no heat on the
+  way.
+*******************************************************************************/
+ThermalPlant::ThermalPlant(double ambientF, double gainF, double tauS,
+                           double deadTimeS, double stepS)
+      :
+      _ambientF(ambientF),
+      _gainF(gainF),
+      _decay(exp(-stepS / tauS)),
+      _tempF(ambientF),
+      _delayLine((size_t)(deadTimeS / stepS + 0.5) + 1, 0.0),
+      _delayIndex(0)
+      {}
+
+/******************************************************************************
+ DESCRIPTION: Advance one step with the heater at power (0..1) for all of
+  it. The power that acts now is the one fed in a dead time ago.
+*******************************************************************************/
+void ThermalPlant::step(double power) {
+  _delayLine[_delayIndex] = power;
+  _delayIndex = (_delayIndex + 1) % _delayLine.size();
+  double delayed = _delayLine[_delayIndex];
+
+  double targetF = _ambientF + _gainF * delayed;
+  _tempF = targetF + (_tempF - targetF) * _decay;
+}
+
+double ThermalPlant::temperatureF() const {
+  return _tempF;
+}
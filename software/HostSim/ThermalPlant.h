@@ -0,0 +1,38 @@
+#ifndef THERMAL_PLANT_H
+#define THERMAL_PLANT_H
+
+#include <stddef.h>
+#include <vector>
+
+/******************************************************************************
+ DESCRIPTION: First-order-plus-dead-time (FOPDT) model of the enclosure:
+  heater power in, air temperature out.
+
+ NOTES:
+  - tau dT/dt = ambient + gain * power(t - deadTime) - T, with power 0..1.
+    gain is how far above ambient full power would eventually hold the
+    box; tau and the dead time set how sluggishly it gets there. Those three
+    numbers are the usual fit to a step test, so a real box can be matched
+    from one logged heat-up.
+  - step() is called at a fixed interval (given to the constructor) and
+    integrates exactly over it, so the step size only limits how finely
+    the heater's switching is seen, not the accuracy.
+*******************************************************************************/
+class ThermalPlant {
+  public:
+    ThermalPlant(double ambientF, double gainF, double tauS, double deadTimeS,
+                 double stepS);
+
+    void step(double power);
+    double temperatureF() const;
+
+  private:
+    double _ambientF;
+    double _gainF;
+    double _decay;                // exp(-step / tau)
+    double _tempF;
+    std::vector<double> _delayLine;   // power still in transit, oldest first
+    size_t _delayIndex;
+};
+
+#endif // THERMAL_PLANT_H
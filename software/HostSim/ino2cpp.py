@@ -0,0 +1,44 @@
+#!/usr/bin/env python3
+"""Turn a sketch's .ino into the .cpp the Arduino IDE would compile.
+
+The IDE puts #include <Arduino.h> at the top and a prototype for every
+function defined in the sketch ahead of the first one, so functions can be
+called before they are defined. This does the same, well enough for our
+sketches, and adds #line directives so errors point back at the .ino.
+
+usage: ino2cpp.py SKETCH.ino OUT.cpp
+"""
+import os
+import re
+import sys
+
+# A function definition starting at column 0: return type, name, (args) {
+# Control statements and constexpr/inline/template helpers don't need one.
+FUNCTION = re.compile(
+    r'^(?!constexpr|inline|template|static_assert|if|for|while|switch|else|return)'
+    r'[A-Za-z_][A-Za-z0-9_<>:\* ]*[ \*]([A-Za-z_][A-Za-z0-9_]*)\(([^;{]*)\)\s*\{')
+
+
+def main(ino_path, out_path):
+    with open(ino_path) as f:
+        lines = f.read().split('\n')
+    name = os.path.basename(ino_path)
+
+    prototypes = [re.sub(r'\s*\{.*$', ';', line) for line in lines
+                  if FUNCTION.match(line) and not line.startswith('ISR')]
+    first = next(i for i, line in enumerate(lines) if FUNCTION.match(line))
+
+    out = ['#include <Arduino.h>', '#line 1 "%s"' % name]
+    for i, line in enumerate(lines):
+        if i == first:
+            out += prototypes + ['#line %d "%s"' % (i + 1, name)]
+        out.append(line)
+
+    with open(out_path, 'w') as f:
+        f.write('\n'.join(out))
+
+
+if __name__ == '__main__':
+    if len(sys.argv) != 3:
+        sys.exit(__doc__)
+    main(sys.argv[1], sys.argv[2])
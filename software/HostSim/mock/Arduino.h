@@ -0,0 +1,78 @@
+#ifndef SIM_ARDUINO_H
+#define SIM_ARDUINO_H
+
+/******************************************************************************
+ DESCRIPTION: Stand-in for the Arduino core, so the Temperature Controller
+  sketch compiles and runs on the desktop (see ../readme.md).
+
+ NOTES:
+  - Only what the sketch uses is here. Time is virtual: millis() and
+    micros() only move when the simulation advances them (from delay(),
+    the sleep calls, or the harness itself), never by themselves.
+  - Pin numbers follow ATTinyCore's ATtiny84 numbering: 0..7 are PA0..PA7,
+    8 = PB2, 9 = PB1, 10 = PB0, 11 = PB3.
+  - The definitions live in MockArduino.cpp.
+*******************************************************************************/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+
+#ifndef F_CPU
+#define F_CPU 8000000UL
+#endif
+
+typedef uint8_t byte;
+
+#define HIGH 1
+#define LOW  0
+#define INPUT        0
+#define OUTPUT       1
+#define INPUT_PULLUP 2
+
+#define DEFAULT     0
+#define EXTERNAL    1
+#define INTERNAL1V1 2
+#define INTERNAL    INTERNAL1V1
+
+enum {
+  PIN_PA0 = 0, PIN_PA1, PIN_PA2, PIN_PA3, PIN_PA4, PIN_PA5, PIN_PA6, PIN_PA7,
+  PIN_PB2, PIN_PB1, PIN_PB0, PIN_PB3
+};
+
+// Analog pins, as ATTinyCore encodes them for analogRead()
+#define A0 (0x80 | 0)
+#define A1 (0x80 | 1)
+#define A2 (0x80 | 2)
+#define A3 (0x80 | 3)
+#define A4 (0x80 | 4)
+#define A5 (0x80 | 5)
+#define A6 (0x80 | 6)
+#define A7 (0x80 | 7)
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int  digitalRead(uint8_t pin);
+int  analogRead(uint8_t pin);
+void analogReference(uint8_t mode);
+
+uint8_t digitalPinToPort(uint8_t pin);
+uint8_t digitalPinToBitMask(uint8_t pin);
+volatile uint8_t* portOutputRegister(uint8_t port);
+volatile uint8_t* portInputRegister(uint8_t port);
+volatile uint8_t* portModeRegister(uint8_t port);
+
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+template <class T> T constrain(T x, T lo, T hi) { return x < lo ? lo : (x > hi ? hi : x); }
+
+#endif // SIM_ARDUINO_H
@@ -0,0 +1,16 @@
+#ifndef SIM_AVR_EEPROM_H
+#define SIM_AVR_EEPROM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Backed by a 512-byte array that starts erased (all 0xFF). Writes complete
+// at once, so eeprom_is_ready() is always true.
+uint8_t eeprom_read_byte(const uint8_t* addr);
+void    eeprom_write_byte(uint8_t* addr, uint8_t value);
+void    eeprom_update_byte(uint8_t* addr, uint8_t value);
+void    eeprom_read_block(void* dst, const void* src, size_t n);
+void    eeprom_update_block(const void* src, void* dst, size_t n);
+uint8_t eeprom_is_ready();
+
+#endif // SIM_AVR_EEPROM_H
@@ -0,0 +1,11 @@
+#ifndef SIM_AVR_INTERRUPT_H
+#define SIM_AVR_INTERRUPT_H
+
+// ISRs become plain C functions that the simulation calls when the matching
+// interrupt would fire (see MockArduino.cpp). There is only one thread, so
+// cli()/sei() have nothing to do.
+#define ISR(vector) extern "C" void vector(void)
+#define sei() ((void)0)
+#define cli() ((void)0)
+
+#endif // SIM_AVR_INTERRUPT_H
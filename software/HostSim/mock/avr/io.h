@@ -0,0 +1,138 @@
+#ifndef SIM_AVR_IO_H
+#define SIM_AVR_IO_H
+
+/******************************************************************************
+ DESCRIPTION: ATtiny84A registers and bit names for the host simulation.
+
+ NOTES:
+  - Registers are plain variables, defined in MockArduino.cpp from the
+    SIM_REGISTERS list. Only what the sketch relies on is modelled behind
+    them (see MockArduino.cpp); the rest just hold what was written.
+*******************************************************************************/
+
+#include <stdint.h>
+
+#define _BV(b) (1u << (b))
+
+#define SIM_REGISTERS(R8, R16) \
+  R8(PORTA) R8(PORTB) R8(DDRA) R8(DDRB) R8(PINA) R8(PINB) \
+  R8(ADMUX) R8(ADCSRA) R8(ADCSRB) R8(DIDR0) R16(ADC) R8(ADCL) R8(ADCH) \
+  R8(TCCR1A) R8(TCCR1B) R8(TCCR1C) R16(TCNT1) R16(OCR1A) R16(OCR1B) R16(ICR1) \
+  R8(TIMSK1) R8(TIFR1) R8(TCCR0A) R8(TCCR0B) R8(TCNT0) R8(OCR0A) R8(TIMSK0) \
+  R8(MCUCR) R8(MCUSR) R8(WDTCSR) R8(GIMSK) R8(GIFR) R8(PCMSK0) R8(PCMSK1) \
+  R8(SREG) R8(PRR) R8(GPIOR0) R8(OSCCAL) R8(OCR0B) R8(TIFR0)
+
+#define SIM_DECLARE_REG8(name)  extern volatile uint8_t name;
+#define SIM_DECLARE_REG16(name) extern volatile uint16_t name;
+SIM_REGISTERS(SIM_DECLARE_REG8, SIM_DECLARE_REG16)
+
+#define PORTA0 0
+#define PORTA1 1
+#define PORTA2 2
+#define PORTA3 3
+#define PORTA4 4
+#define PORTA5 5
+#define PORTA6 6
+#define PORTA7 7
+#define PORTB0 0
+#define PORTB1 1
+#define PORTB2 2
+#define PORTB3 3
+#define PA0 0
+#define PA1 1
+#define PA2 2
+#define PA3 3
+#define PA4 4
+#define PA5 5
+#define PA6 6
+#define PA7 7
+#define PB0 0
+#define PB1 1
+#define PB2 2
+#define PB3 3
+#define REFS1 7
+#define REFS0 6
+#define MUX5 5
+#define MUX4 4
+#define MUX3 3
+#define MUX2 2
+#define MUX1 1
+#define MUX0 0
+#define ADEN 7
+#define ADSC 6
+#define ADATE 5
+#define ADIF 4
+#define ADIE 3
+#define ADPS2 2
+#define ADPS1 1
+#define ADPS0 0
+#define BIN 7
+#define ACME 6
+#define ADLAR 4
+#define ADTS2 2
+#define ADTS1 1
+#define ADTS0 0
+#define ADC7D 7
+#define ADC3D 3
+#define WGM13 4
+#define WGM12 3
+#define WGM11 1
+#define WGM10 0
+#define CS12 2
+#define CS11 1
+#define CS10 0
+#define COM1A1 7
+#define COM1A0 6
+#define COM1B1 5
+#define COM1B0 4
+#define OCIE1B 2
+#define OCIE1A 1
+#define TOIE1 0
+#define OCF1B 2
+#define OCF1A 1
+#define TOV1 0
+#define FOC1A 7
+#define BODS 7
+#define PUD 6
+#define SE 5
+#define SM1 4
+#define SM0 3
+#define BODSE 2
+#define ISC01 1
+#define ISC00 0
+#define WDIF 7
+#define WDIE 6
+#define WDP3 5
+#define WDCE 4
+#define WDE 3
+#define WDP2 2
+#define WDP1 1
+#define WDP0 0
+#define WDRF 3
+#define BORF 2
+#define EXTRF 1
+#define PORF 0
+#define INT0 6
+#define PCIE1 5
+#define PCIE0 4
+#define PCINT0 0
+#define PCINT1 1
+#define PCINT2 2
+#define PRTIM1 3
+#define PRTIM0 2
+#define PRUSI 1
+#define PRADC 0
+#define E2END 511
+#define OCIE0B 2
+#define OCIE0A 1
+#define TOIE0 0
+#define OCF0B 2
+#define OCF0A 1
+#define TOV0 0
+#define WGM00 0
+#define WGM01 1
+#define WGM02 3
+#define COM0B0 4
+#define COM0B1 5
+
+#endif // SIM_AVR_IO_H
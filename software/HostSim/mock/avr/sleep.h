@@ -0,0 +1,18 @@
+#ifndef SIM_AVR_SLEEP_H
+#define SIM_AVR_SLEEP_H
+
+#include <stdint.h>
+
+#define SLEEP_MODE_IDLE     0
+#define SLEEP_MODE_ADC      1
+#define SLEEP_MODE_PWR_DOWN 2
+#define SLEEP_MODE_STANDBY  3
+
+// sleep_cpu() advances virtual time to the next millis() tick, which is
+// what wakes the real chip from idle sleep.
+void set_sleep_mode(uint8_t mode);
+void sleep_enable();
+void sleep_disable();
+void sleep_cpu();
+
+#endif // SIM_AVR_SLEEP_H
@@ -0,0 +1,19 @@
+#ifndef POC_BUILD_OPTIONS_H
+#define POC_BUILD_OPTIONS_H
+
+/******************************************************************************
+ DESCRIPTION: Build options for the temperature-sensing proof of concept.
+
+ NOTES:
+  - AppProfile.h in this folder is a symlink into ../TemperatureController,
+    so the set-point range and band come from the controller's bench
+    profile rather than a copy of them. It includes "BuildOptions.h", which
+    here is this file: it picks the bench profile, then takes everything
+    else from the controller's own BuildOptions.h (ControllerBuildOptions.h).
+*******************************************************************************/
+
+#define TC_APP TC_APP_BENCH     // 30..70 °F, a 3 °F band (see AppProfile.h)
+
+#include "ControllerBuildOptions.h"
+
+#endif // POC_BUILD_OPTIONS_H
@@ -9,9 +9,15 @@
     Temperature Sensor is a TI LM19 analog sensor IC
 
  12-05-2025: Initial attempt
+ 10-14-2026: LM19 read through the shared driver in software/libraries/LM19
+ 10-14-2026: Set-point range, band and update period from the controller's
+             bench profile (AppProfile.h); the band is now 3 °F wide, as in
+             the controller, rather than +/-3 °F
 *********************************************************************/
 
 #include <Arduino.h>
+#include <LM19.h>
+#include "AppProfile.h"
 
 /**************************************************************************
  * Initiization Section
@@ -23,17 +29,14 @@
   const uint8_t POT_PIN   = PIN_PA3;       // physical pin 10 - setpoint pot
   const uint8_t LED_PIN   = PIN_PA0;  // physical pin 13 - status LED
 
-  // --- Config Global Variables ---
-  const float VREF        = 5.0;      // using Vcc as ADC reference
-  const float LM19_V0C    = 1.8663;   // approx Vout at 0°C (from datasheet)
-  const float LM19_SLOPE  = 0.01169;  // V/°C (output decreases as temp rises)
+  // --- LM19 on ADC7 (TEMP_PIN), Vcc as ADC reference; see LM19.h ---
+  typedef Lm19<7, Lm19OnVcc5V> TempSensor;
 
-  // Setpoint range in °F (you can tweak these later)
-  const float MIN_SET_F   = 30.0;
-  const float MAX_SET_F   = 70.0;
-
-  // Hysteresis band in °F
-  const float HYST_F      = 3.0;
+  // Setpoint range and hysteresis band in °F: the bench profile's (tweak
+  // them in AppProfile.h, where the controller's bench build gets them too)
+  const float MIN_SET_F   = APP.minSetF;
+  const float MAX_SET_F   = APP.maxSetF;
+  const float HYST_F      = APP.hystF;     // full width of the band
 
   bool heaterOn = false;
 
@@ -61,39 +64,17 @@ void loop(void)
   float tempF = readTemperatureF();
   float setF  = readSetpointF();
   updateHeater(tempF, setF);
-  delay(1000);  // 1-second update period for testing
-
-}
-
-/****************************************************************************
-  PURPOSE: Get the temperature from the sensor, in it's native units
-*****************************************************************************/
-float readTemperatureC() {
-  const uint8_t N_SAMPLES = 8;  // Take 8 reading samples and average them.
-  uint32_t sum = 0;
-
-  for (uint8_t i = 0; i < N_SAMPLES; i++) {
-    sum += analogRead(TEMP_PIN);
-  }
-
-  float raw = sum / (float)N_SAMPLES;
-  float v = (raw * VREF) / 1023.0;
-
-  // Clamp to sane range for LM19
-  if (v < 0.2) v = 0.2;
-  if (v > 2.8) v = 2.8;
+  delay(APP.controlUpdateMs);  // 1-second update period for testing
 
-  float tC = (LM19_V0C - v) / LM19_SLOPE;
-  return tC;
 }
 
 /****************************************************************************
-  PURPOSE: Convert sensor's native units to farenheit units
+  PURPOSE: Get the temperature from the sensor, in farenheit units. The
+  driver averages 8 readings and clamps them to the LM19's sane range.
 *****************************************************************************/
 float readTemperatureF() {
 
-  float c = readTemperatureC();
-  return c * 9.0 / 5.0 + 32.0;
+  return TempSensor::readF();
 
 }
 
@@ -114,9 +95,9 @@ float readSetpointF() {
 *****************************************************************************/
 void updateHeater(float tempF, float setF) {
   // Simple hysteresis control
-  if (tempF <= setF - HYST_F) {
+  if (tempF <= setF - HYST_F / 2) {
     heaterOn = true;
-  } else if (tempF >= setF + HYST_F) {
+  } else if (tempF >= setF + HYST_F / 2) {
     heaterOn = false;
   }
 
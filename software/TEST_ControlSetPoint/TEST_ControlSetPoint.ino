@@ -1,6 +1,8 @@
 // ATtiny84A + LM19 + Pot + SSR/LED
 // Simple thermostat with debug LED states
 
+#include <LM19.h>
+
 // --- Pin assignments (digital) ---
 const uint8_t SSR_PIN   = PIN_PB0;  // physical pin 2 - SSR control
 const uint8_t LED_PIN   = PIN_PA0;  // physical pin 13 - status LED
@@ -12,10 +14,8 @@ const uint8_t LED_PIN   = PIN_PA0;  // physical pin 13 - status LED
 const uint8_t TEMP_PIN  = A7;       // LM19 Vout on PA7
 const uint8_t POT_PIN   = A3;       // Pot wiper on PA3
 
-// --- LM19 constants ---
-const float VREF        = 5.0;
-const float LM19_V0C    = 1.8663;
-const float LM19_SLOPE  = 0.01169;
+// --- LM19 on ADC7, Vcc as ADC reference (see LM19.h) ---
+typedef Lm19<7, Lm19OnVcc5V> TempSensor;
 
 // --- Setpoint range ---
 const float MIN_SET_F   = 50.0;
@@ -28,30 +28,9 @@ const float HYST_F      = 2.0;  // start with 2°F
 float filteredTempF = 70.0;
 bool heaterOn = false;
 
-// --- Read LM19, return °C ---
-float readTemperatureC() {
-  const uint8_t N_SAMPLES = 8;
-  uint32_t sum = 0;
-
-  for (uint8_t i = 0; i < N_SAMPLES; i++) {
-    sum += analogRead(TEMP_PIN);
-  }
-
-  float raw = sum / (float)N_SAMPLES;
-  float v = (raw * VREF) / 1023.0;
-
-  // Clamp to sane LM19 range
-  if (v < 0.2) v = 0.2;
-  if (v > 2.8) v = 2.8;
-
-  float tC = (LM19_V0C - v) / LM19_SLOPE;
-  return tC;
-}
-
-// --- Convert °C to °F ---
+// --- Read LM19 (8-reading average, clamped), return °F ---
 float readTemperatureF() {
-  float c = readTemperatureC();
-  return c * 9.0 / 5.0 + 32.0;
+  return TempSensor::readF();
 }
 
 // --- Read pot and map 0–1023 to 50–90°F linearly ---
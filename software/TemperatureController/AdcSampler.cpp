@@ -0,0 +1,266 @@
+#include "BuildOptions.h"
+#include "AdcSampler.h"
+#include <avr/sleep.h>
+
+// Only build the sampler (and claim the ADC interrupt vector) when it is used.
+#if TC_ADC_INTERRUPT || TC_ADC_NOISE_SLEEP
+
+AdcSampler adcSampler;
+
+/******************************************************************************
+ DESCRIPTION: ADC prescaler. The ADC wants a 50..200 kHz clock for full
+  10-bit accuracy, so pick the divider from the CPU clock at compile time.
+*******************************************************************************/
+#if F_CPU >= 12800000UL
+static const uint8_t ADC_PRESCALE_BITS = _BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0); // /128
+#elif F_CPU >= 6400000UL
+static const uint8_t ADC_PRESCALE_BITS = _BV(ADPS2) | _BV(ADPS1);              // /64
+#elif F_CPU >= 3200000UL
+static const uint8_t ADC_PRESCALE_BITS = _BV(ADPS2) | _BV(ADPS0);              // /32
+#else
+static const uint8_t ADC_PRESCALE_BITS = _BV(ADPS1) | _BV(ADPS0);              // /8
+#endif
+
+static const uint8_t ADMUX_REFS_MASK = _BV(REFS1) | _BV(REFS0);
+static const uint8_t ADTS_TIMER0_OVF = _BV(ADTS2);   // ADTS = 100
+
+// ADMUX for a mux number: its own reference bits if it has them, otherwise
+// the reference already selected.
+static uint8_t admuxFor(uint8_t mux) {
+  return (mux & ADMUX_REFS_MASK) ? mux : (uint8_t)((ADMUX & ADMUX_REFS_MASK) | mux);
+}
+
+static bool refChanges(uint8_t admux) {
+  return ((ADMUX ^ admux) & ADMUX_REFS_MASK) != 0;
+}
+
+/******************************************************************************
+ DESCRIPTION: Constructor, using initializer list. Nothing touches the
+  hardware until begin().
+*******************************************************************************/
+AdcSampler::AdcSampler()
+      :
+      _blockSamples(1),
+      _channel(Temp),
+      _count(0),
+      _acc(0),
+      _tempInBackground(true),
+      _settling(false),
+      _sleepMode(false),
+      _sleepDone(false),
+      _sleepResult(0),
+      _blanking(false),
+      _blankEndMs(0)
+      {
+        for (uint8_t ch = 0; ch < NUM_CHANNELS; ch++) {
+          _mux[ch]      = 0;
+          _overruns[ch] = 0;
+        }
+      }
+
+/******************************************************************************
+ DESCRIPTION: Configure the ADC and start sampling.
+
+ NOTES:
+  - tempMux/potMux are ADC channel numbers (the MUX bits in ADMUX), e.g. 7
+    for ADC7 on PA7; not Arduino pin numbers. OR in REF_1V1 to read that
+    channel against the internal 1.1 V reference.
+  - blockSamples readings are summed into each buffered block. Keep it at
+    64 or below so a block of 10-bit readings fits a uint16_t.
+  - A channel without REF_1V1 keeps the reference bits already in ADMUX
+    (set by analogReference()).
+  - tempInBackground = false leaves the LM19 to sampleInSleep(); the ISR then
+    only ever converts the pot.
+*******************************************************************************/
+void AdcSampler::begin(uint8_t tempMux, uint8_t potMux, uint8_t blockSamples,
+                       bool tempInBackground) {
+  _mux[Temp]        = admuxFor(tempMux);
+  _mux[Pot]         = admuxFor(potMux);
+  _blockSamples     = blockSamples ? blockSamples : 1;
+  _tempInBackground = tempInBackground;
+  _channel          = tempInBackground ? Temp : Pot;
+  _count            = 0;
+  _acc              = 0;
+  _settling         = true;   // the reference may have just been switched on
+
+  ADMUX  = _mux[_channel];
+  ADCSRB = (ADCSRB & ~(_BV(ADTS2) | _BV(ADTS1) | _BV(ADTS0))) | ADTS_TIMER0_OVF;
+  ADCSRA = _BV(ADEN) | _BV(ADATE) | _BV(ADIE) | _BV(ADIF) | ADC_PRESCALE_BITS;
+}
+
+/******************************************************************************
+ DESCRIPTION: Take the oldest finished block for a channel, if there is one.
+  Returns false when the ring buffer is empty.
+*******************************************************************************/
+bool AdcSampler::popBlock(Channel ch, uint16_t& blockSum) {
+  return _rings[ch].pop(blockSum);
+}
+
+/******************************************************************************
+ DESCRIPTION: Take every finished block for a channel. Adds their sums into
+  total and returns how many blocks there were (0 if none).
+
+ NOTES:
+  - This is the cheap way to oversample: all the readings the ISR collected
+    since the last call are averaged in, at no cost to the main loop.
+*******************************************************************************/
+uint8_t AdcSampler::drain(Channel ch, uint32_t& total) {
+  uint8_t blocks = 0;
+  uint16_t blockSum;
+
+  while (_rings[ch].pop(blockSum)) {
+    total += blockSum;
+    blocks++;
+  }
+  return blocks;
+}
+
+/******************************************************************************
+ DESCRIPTION: Hold off readings for the next ms milliseconds (1..255).
+
+ NOTES:
+  - Safe from an ISR. A window already running is only ever lengthened.
+  - Before begin() it only delays the first block.
+*******************************************************************************/
+void AdcSampler::blank(uint8_t ms) {
+  uint8_t sreg = SREG;    // 16-bit value shared with the ISR
+  cli();
+  uint16_t endMs = (uint16_t)millis() + ms;
+  if (!_blanking || (int16_t)(endMs - _blankEndMs) > 0) {
+    _blankEndMs = endMs;
+  }
+  _blanking = true;
+  SREG = sreg;
+}
+
+/******************************************************************************
+ DESCRIPTION: Is a blank() window still running? Ends it once it is over.
+*******************************************************************************/
+bool AdcSampler::blanked() {
+  if (!_blanking) return false;
+
+  uint8_t sreg = SREG;
+  cli();
+  bool running = (int16_t)((uint16_t)millis() - _blankEndMs) < 0;
+  if (!running) _blanking = false;
+  SREG = sreg;
+  return running;
+}
+
+/******************************************************************************
+ DESCRIPTION: Take count readings of one channel with the CPU asleep in ADC
+  Noise Reduction mode during each conversion, and return their sum.
+
+ NOTES:
+  - Works whether or not begin() was called. Background sampling is paused
+    for the duration and the ADC registers are put back as they were.
+  - Entering ADC Noise Reduction sleep starts the conversion by itself, and
+    the conversion-complete interrupt wakes us. If something else wakes us
+    first (pin change, watchdog) we just go back to sleep until the result
+    is in.
+  - The I/O clock is stopped in this sleep mode, so Timer0 and millis() lose
+    about one conversion time (~100 us at 8 MHz) per reading. At a few
+    readings per sample tick that is well under 0.5% and harmless here.
+  - count must be 64 or less so the sum fits a uint16_t. If mux asks for a
+    different reference from the last conversion, or is MUX_BANDGAP, one
+    more reading is taken first and dropped.
+  - A blank() window still running is waited out first, in idle sleep:
+    the I/O clock, and so millis(), stop in noise-reduction sleep. Nothing
+    can start a new window meanwhile, since the timers that switch the SSR
+    stop too.
+*******************************************************************************/
+uint16_t AdcSampler::sampleInSleep(uint8_t mux, uint8_t count) {
+  const uint8_t savedAdcsra = ADCSRA;
+  const uint8_t admux = admuxFor(mux);
+  const uint8_t skip  = (refChanges(admux) || (admux & 0x3F) == MUX_BANDGAP) ? 1 : 0;
+  uint16_t sum = 0;
+
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  while (blanked()) {
+    sleep_enable();
+    sleep_cpu();
+    sleep_disable();
+  }
+
+  // Stop auto-triggering and let any background conversion finish
+  ADCSRA = savedAdcsra & ~(_BV(ADATE) | _BV(ADIE));
+  while (ADCSRA & _BV(ADSC)) {}
+  ADCSRA = _BV(ADEN) | _BV(ADIE) | _BV(ADIF) | ADC_PRESCALE_BITS;
+
+  _sleepMode = true;
+  ADMUX = admux;
+  set_sleep_mode(SLEEP_MODE_ADC);
+
+  for (uint8_t i = 0; i < count + skip; i++) {
+    _sleepDone = false;
+    while (!_sleepDone) {
+      sleep_enable();
+      sleep_cpu();
+      sleep_disable();
+    }
+    if (i >= skip) sum += _sleepResult;
+  }
+
+  _sleepMode = false;
+
+  // Back to the background channel, with a clean block
+  _count    = 0;
+  _acc      = 0;
+  _settling = refChanges(_mux[_channel]);
+  ADMUX     = _mux[_channel];
+  ADCSRA    = savedAdcsra | _BV(ADIF);
+  return sum;
+}
+
+/******************************************************************************
+ DESCRIPTION: Conversion-complete handler. Keep it short; it runs about every
+  2 ms.
+*******************************************************************************/
+void AdcSampler::onConversion() {
+  if (_sleepMode) {
+    _sleepResult = ADC;
+    _sleepDone   = true;
+    return;
+  }
+  if (_settling) {
+    _settling = false;
+    return;
+  }
+  if (blanked()) return;
+
+  _acc += ADC;
+  if (++_count < _blockSamples) return;
+
+  uint8_t ch = _channel;
+  if (!_rings[ch].push(_acc) && _overruns[ch] < 0xFF) {
+    _overruns[ch]++;
+  }
+  _acc   = 0;
+  _count = 0;
+
+  // The next conversion won't start until the next Timer0 overflow, so
+  // the multiplexer can be switched right now.
+  if (_tempInBackground) {
+    ch ^= 1;
+    _channel = ch;
+  }
+  _settling = refChanges(_mux[ch]);
+  ADMUX     = _mux[ch];
+}
+
+/******************************************************************************
+ DESCRIPTION: Getter methods
+*******************************************************************************/
+uint8_t AdcSampler::blockSamples() const {
+  return _blockSamples;
+}
+
+uint8_t AdcSampler::overruns(Channel ch) const {
+  return _overruns[ch];
+}
+
+ISR(ADC_vect) {
+  adcSampler.onConversion();
+}
+
+#endif // TC_ADC_INTERRUPT || TC_ADC_NOISE_SLEEP
@@ -0,0 +1,90 @@
+#ifndef ADC_SAMPLER_H
+#define ADC_SAMPLER_H
+
+#include <Arduino.h>
+#include "RingBuffer.h"
+
+/******************************************************************************
+ DESCRIPTION: This class is part of the Temperature Controller application.
+  It runs the ADC in the background, off the conversion-complete interrupt,
+  so the tasks never have to wait on analogRead().
+
+ NOTES:
+  - Conversions are auto-triggered by the Timer0 overflow that already drives
+    millis() (about every 2 ms at 8 MHz), so the sampler needs no timer of
+    its own and paces itself at roughly 500 conversions per second.
+  - The ISR alternates between the two channels. It adds up blockSamples
+    readings of one channel, pushes that sum into the channel's ring buffer,
+    then switches the multiplexer to the other channel.
+  - Each channel has its own ring buffer so each has exactly one consumer:
+    the temperature task drains Temp, the control task drains Pot. If a
+    buffer fills up, new blocks are dropped and counted in overruns(). The
+    pot is only read once a second, so its buffer filling up is normal and
+    just means the reading used is up to a second old.
+  - Once begin() is called, do not use analogRead(); it would fight the ISR
+    for the multiplexer.
+  - A channel can have its own ADC reference: pass its mux number ORed with
+    REF_1V1 for the internal 1.1 V bandgap. Channels without one use
+    whatever analogReference() set. The first conversion after the
+    reference changes is off, so it is thrown away; that happens once a
+    block, and once per sampleInSleep() call.
+  - sampleInSleep() takes readings with the CPU in ADC Noise Reduction sleep
+    instead, so no CPU or LED-port activity disturbs the conversion. When
+    that is used for the LM19, begin() is told to leave the Temp channel out
+    of the background rotation and the ISR samples only the pot.
+  - blank(ms) keeps the ADC's readings out for the next ms milliseconds:
+    call it on an SSR or LED edge, while the supply it measures against
+    settles. The ISR throws its conversions away until then and
+    sampleInSleep() waits it out before starting. The blocks just take a
+    little longer to fill.
+  - MUX_BANDGAP is the 1.1 V bandgap as the ADC's input. Read against Vcc
+    it gives Vcc itself (1.1 * 1024 / reading); sampleInSleep() throws the
+    first reading away, as for a reference change.
+  - There is exactly one ADC, so there is exactly one instance: adcSampler.
+*******************************************************************************/
+
+class AdcSampler {
+  public:
+    enum Channel : uint8_t { Temp, Pot, NUM_CHANNELS };
+
+    static const uint8_t RING_SIZE = 8;    // blocks buffered per channel
+    static const uint8_t REF_1V1 = _BV(REFS1);   // OR into a mux number
+    static const uint8_t MUX_BANDGAP = 0x21;     // 1.1 V bandgap as the input
+
+    AdcSampler();
+
+    // ---- General Methods ---------------------------------------------------
+    void begin(uint8_t tempMux, uint8_t potMux, uint8_t blockSamples,
+               bool tempInBackground = true);
+    uint16_t sampleInSleep(uint8_t mux, uint8_t count);
+    bool popBlock(Channel ch, uint16_t& blockSum);
+    uint8_t drain(Channel ch, uint32_t& total);
+    void blank(uint8_t ms);
+    void onConversion();        // only called from the ADC ISR
+
+    // ---- Setter/Getter Functions -------------------------------------------
+    uint8_t blockSamples() const;
+    uint8_t overruns(Channel ch) const;
+
+  private:
+    bool blanked();
+
+    RingBuffer<uint16_t, RING_SIZE> _rings[NUM_CHANNELS];
+    uint8_t _mux[NUM_CHANNELS];     // whole ADMUX value, reference included
+    uint8_t _blockSamples;
+    volatile uint8_t _channel;
+    uint8_t _count;
+    uint16_t _acc;
+    volatile uint8_t _overruns[NUM_CHANNELS];
+    bool _tempInBackground;
+    bool _settling;                 // reference just changed; drop this reading
+    volatile bool _sleepMode;
+    volatile bool _sleepDone;
+    volatile uint16_t _sleepResult;
+    volatile bool _blanking;
+    volatile uint16_t _blankEndMs;  // low 16 bits of millis()
+};
+
+extern AdcSampler adcSampler;
+
+#endif // ADC_SAMPLER_H
@@ -0,0 +1,65 @@
+#include "AlphaBetaFilter.h"
+
+static const int32_t MAX_RESIDUAL_Q8 = (int32_t)1 << (14 + AlphaBetaFilter::FRAC_BITS);
+static const int32_t HALF_Q8         = (int32_t)1 << (AlphaBetaFilter::FRAC_BITS - 1);
+
+/******************************************************************************
+ DESCRIPTION: Constructor, using initializer list. Starts at 0, standing
+  still; reset() it to the first real reading.
+*******************************************************************************/
+AlphaBetaFilter::AlphaBetaFilter(uint8_t alphaQ8, uint16_t betaQ16)
+      :
+      _valueQ8(0),
+      _rateQ8(0),
+      _alphaQ8(alphaQ8),
+      _betaQ16(betaQ16)
+      {}
+
+/******************************************************************************
+ DESCRIPTION: Start over at value, with no rate of change.
+*******************************************************************************/
+void AlphaBetaFilter::reset(int32_t value) {
+  _valueQ8 = value * ((int32_t)1 << FRAC_BITS);
+  _rateQ8  = 0;
+}
+
+/******************************************************************************
+ DESCRIPTION: Take in a new reading, 2^shift ticks after the last one.
+
+ NOTES:
+  - The residual is rounded to whole units before the beta multiply, which
+    keeps that multiply inside 32 bits; beta is small enough that the
+    rounding doesn't show.
+*******************************************************************************/
+void AlphaBetaFilter::update(int32_t measured, uint8_t shift) {
+  int32_t predicted = _valueQ8 + _rateQ8 * ((int32_t)1 << shift);
+  int32_t residual  = measured * ((int32_t)1 << FRAC_BITS) - predicted;
+  if (residual >  MAX_RESIDUAL_Q8) residual =  MAX_RESIDUAL_Q8;
+  if (residual < -MAX_RESIDUAL_Q8) residual = -MAX_RESIDUAL_Q8;
+
+  _valueQ8 = predicted + ((residual * _alphaQ8 + 128) >> 8);
+
+  int32_t residualUnits = (residual + HALF_Q8) >> FRAC_BITS;
+  _rateQ8 += ((residualUnits * (int32_t)_betaQ16 + 128) >> 8) >> shift;
+}
+
+/******************************************************************************
+ DESCRIPTION: Getter methods
+
+ NOTES:
+  - value() is the estimate rounded to whole input units.
+  - change() is how far the estimate moves per sample at 2^shift ticks per
+    sample, in whole units: the rate, without the sample-to-sample noise
+    that the difference between two estimates has.
+*******************************************************************************/
+int32_t AlphaBetaFilter::value() const {
+  return (_valueQ8 + HALF_Q8) >> FRAC_BITS;
+}
+
+int32_t AlphaBetaFilter::rateQ8() const {
+  return _rateQ8;
+}
+
+int32_t AlphaBetaFilter::change(uint8_t shift) const {
+  return (_rateQ8 * ((int32_t)1 << shift) + HALF_Q8) >> FRAC_BITS;
+}
@@ -0,0 +1,50 @@
+#ifndef ALPHA_BETA_FILTER_H
+#define ALPHA_BETA_FILTER_H
+
+#include <Arduino.h>
+
+/******************************************************************************
+ DESCRIPTION: This class is part of the Temperature Controller application.
+  It is an integer-only alpha-beta estimator: it tracks a reading and its
+  rate of change, so a steady ramp comes out with no lag, where an EMA
+  trails it by (1 - alpha) / alpha samples (TC_ALPHA_BETA).
+
+ NOTES:
+  - Each update predicts the reading from the last estimate plus the rate,
+    then moves the estimate alpha of the way, and the rate beta of the way,
+    towards what was actually read.
+  - Units are whatever the caller feeds it (LM19 table positions or TempCF);
+    the state carries FRAC_BITS extra fraction bits. The rate is per "tick",
+    the shortest sample interval. A sample that comes 2^shift ticks after
+    the last one says so, and the prediction and the rate step allow for
+    it; alpha and beta stay per sample.
+  - Gains: alphaQ8 is alpha as an 8-bit fraction, betaQ16 beta as a 16-bit
+    one (it is that small). Keep beta below 0.25 so nothing overflows.
+  - A single residual is limited to +/-2^14 input units, far beyond any
+    real change between two samples.
+  - No floats, and 11 bytes of state.
+*******************************************************************************/
+
+class AlphaBetaFilter {
+  public:
+    static const uint8_t FRAC_BITS = 8;
+
+    AlphaBetaFilter(uint8_t alphaQ8, uint16_t betaQ16);
+
+    // ---- General Methods ---------------------------------------------------
+    void reset(int32_t value);
+    void update(int32_t measured, uint8_t shift = 0);
+
+    // ---- Setter/Getter Functions -------------------------------------------
+    int32_t value() const;
+    int32_t rateQ8() const;
+    int32_t change(uint8_t shift = 0) const;
+
+  private:
+    int32_t _valueQ8;       // estimate, FRAC_BITS fraction bits
+    int32_t _rateQ8;        // change per tick, FRAC_BITS fraction bits
+    uint8_t _alphaQ8;
+    uint16_t _betaQ16;
+};
+
+#endif // ALPHA_BETA_FILTER_H
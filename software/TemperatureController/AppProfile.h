@@ -0,0 +1,67 @@
+#ifndef APP_PROFILE_H
+#define APP_PROFILE_H
+
+#include <Arduino.h>
+#include "BuildOptions.h"
+
+/******************************************************************************
+ DESCRIPTION: The settings that change from one use of the controller to the
+  next (what the pot spans, how tight the band is, how quickly it samples),
+  gathered into one profile per use. TC_APP in BuildOptions.h picks one, and
+  it is then known to the sketch as APP.
+
+ NOTES:
+  - Everything is constexpr. The sketch works its integer thresholds,
+    ADC-count ranges, the pot mapping and the LM19 table out from APP at
+    compile time, so a profile costs nothing at run time and no float
+    reaches the integer builds' hot path.
+  - appProfileOk() is the sanity check on a profile; the sketch
+    static_asserts it, so a bad profile fails the build. The checks that
+    need the LM19 table (is the range inside what the sensor can read?) are
+    made in the sketch too, next to the table.
+  - The bench profile is the POC_TempSense sketch's settings. That sketch
+    and BENCH_Controller have this file as a symlink and pick the profile
+    with TC_APP_BENCH, so neither keeps a hand-edited copy of them.
+  - Add a profile by adding a constant and a TC_APP_ value for it; keep the
+    range on whole setStepF steps.
+*******************************************************************************/
+
+struct AppProfile {
+  float minSetF;               // bottom of pot
+  float midSetF;               // middle of pot
+  float maxSetF;               // top of pot
+  float setStepF;              // set-point resolution (see SetpointKnob)
+  float hystF;                 // hysteresis band, full width
+  float tempAlpha;             // EMA factor for the filtered temperature
+  uint16_t tempSampleMs;       // how often to sample the LM19
+  uint16_t controlUpdateMs;    // how often to update the heater
+};
+
+// Kiln-drying lumber: the original settings
+constexpr AppProfile WOOD_DRYER_PROFILE    = { 50.0f, 72.0f, 90.0f, 0.5f, 2.0f, 0.1f, 250, 1000 };
+
+// Proofing dough: a small box, a narrow range around 80 °F and a tight band
+constexpr AppProfile BREAD_PROOFER_PROFILE = { 70.0f, 80.0f, 95.0f, 0.5f, 1.0f, 0.1f, 250, 1000 };
+
+// Bench testing with the POC_TempSense set-up
+constexpr AppProfile BENCH_PROFILE         = { 30.0f, 50.0f, 70.0f, 0.5f, 3.0f, 0.1f, 250, 1000 };
+
+constexpr bool appProfileOk(const AppProfile& p) {
+  return p.minSetF < p.midSetF && p.midSetF < p.maxSetF &&
+         p.setStepF > 0.0f &&
+         p.hystF > 0.0f && p.hystF < p.maxSetF - p.minSetF &&
+         p.tempAlpha > 0.0f && p.tempAlpha < 1.0f &&
+         p.tempSampleMs > 0 && p.tempSampleMs <= p.controlUpdateMs;
+}
+
+#if TC_APP == TC_APP_WOOD_DRYER
+constexpr AppProfile APP = WOOD_DRYER_PROFILE;
+#elif TC_APP == TC_APP_BREAD_PROOFER
+constexpr AppProfile APP = BREAD_PROOFER_PROFILE;
+#else // TC_APP_BENCH; BuildOptions.h has checked it is one of the three
+constexpr AppProfile APP = BENCH_PROFILE;
+#endif
+
+static_assert(appProfileOk(APP), "The TC_APP profile has a bad range, band, alpha or interval");
+
+#endif // APP_PROFILE_H
@@ -0,0 +1,319 @@
+#ifndef BUILD_OPTIONS_H
+#define BUILD_OPTIONS_H
+
+/******************************************************************************
+ DESCRIPTION: Compile-time build options for the Temperature Controller.
+
+ NOTES:
+  - Every option is a 0/1 switch. Edit the value here rather than adding
+    #defines to the .ino; the Arduino build compiles each .cpp file on its
+    own, so a #define in the sketch would not be seen by the other modules.
+  - Options that depend on one another are checked at the bottom of this
+    file so a bad combination fails at compile time, not on the bench.
+*******************************************************************************/
+
+// ---------------- Application -----------------------------------------------
+// What the controller is for; picks the set-point range, band, filter and
+// task intervals (see AppProfile.h):
+#define TC_APP_WOOD_DRYER    0   // kiln-drying lumber, as originally written
+#define TC_APP_BREAD_PROOFER 1   // proofing dough, 70..95 °F with a 1 °F band
+#define TC_APP_BENCH         2   // the POC_TempSense bench set-up, 30..70 °F
+#ifndef TC_APP
+#define TC_APP TC_APP_WOOD_DRYER
+#endif
+
+// ---------------- Temperature Math -----------------------------------------
+// 1 = integer-only pipeline (ADC → °F → EMA → control) in hundredths of a
+//     degree F. Keeps the soft-float library out of the flash image.
+// 0 = original float pipeline.
+#ifndef TC_FIXED_POINT
+#define TC_FIXED_POINT 1
+#endif
+
+// 1 = control compares the filtered LM19 reading against on/off thresholds
+//     held as raw ADC counts. The thresholds are rebuilt only when the pot
+//     moves, so the control path does no temperature conversion at all.
+//     Requires TC_FIXED_POINT.
+#ifndef TC_COUNT_THRESHOLDS
+#define TC_COUNT_THRESHOLDS 1
+#endif
+
+// ---------------- ADC Sampling ----------------------------------------------
+// 1 = the ADC runs in the background off its conversion-complete interrupt
+//     (see AdcSampler.h); the tasks drain buffered readings instead of
+//     waiting on analogRead(). Requires TC_FIXED_POINT.
+#ifndef TC_ADC_INTERRUPT
+#define TC_ADC_INTERRUPT 1
+#endif
+
+// 1 = the LM19 is read with the CPU in ADC Noise Reduction sleep during each
+//     conversion (see AdcSampler::sampleInSleep()). Quieter readings mean
+//     fewer are needed per sample. With TC_ADC_INTERRUPT the background
+//     sampler then only handles the pot. The sleep stops the timers, so
+//     not with TC_OUTPUT_PHASE_ANGLE. Requires TC_FIXED_POINT.
+#ifndef TC_ADC_NOISE_SLEEP
+#define TC_ADC_NOISE_SLEEP 1
+#endif
+
+// 1 = oversample and decimate: each LM19 sample is exactly 4^n background
+//     readings (n = TEMP_DECIMATE_BITS in the sketch), summed and shifted
+//     down by n for n extra bits of resolution. Needs a little noise on the
+//     input to work, so it replaces TC_ADC_NOISE_SLEEP rather than adding to
+//     it. Requires TC_ADC_INTERRUPT.
+#ifndef TC_ADC_DECIMATE
+#define TC_ADC_DECIMATE 0
+#endif
+
+// 1 = the LM19 sample interval stretches from TEMP_SAMPLE_MS to up to 16x
+//     that (8x with TC_ALPHA_BETA) while the temperature is steady and well
+//     clear of the next band edge, the one on/off control is heading for,
+//     and drops back as soon as it nears it or moves quickly. The EMA is
+//     corrected for the interval. The sample task has to be what
+//     takes the readings, so with TC_ADC_INTERRUPT this needs
+//     TC_ADC_NOISE_SLEEP. Requires TC_FIXED_POINT.
+#ifndef TC_ADAPTIVE_SAMPLING
+#define TC_ADAPTIVE_SAMPLING 0
+#endif
+
+// 1 = the LM19 is read against the internal 1.1 V reference, through a
+//     divider on its output (LM19_DIV_* in the sketch), instead of against
+//     Vcc: ~2.5x the resolution per count, and supply ripple stays out of
+//     the reading. The pot is ratiometric, so it stays on Vcc; the ADC
+//     switches reference between the two. Needs the divider fitted.
+#ifndef TC_ADC_INTERNAL_REF
+#define TC_ADC_INTERNAL_REF 0
+#endif
+
+// 1 = the ADC's readings are thrown away for a short window after every SSR
+//     edge (SSR_BLANK_MS in the sketch) and LED change (LED_BLANK_MS), while
+//     the supply it measures against settles from the step in load (see
+//     AdcSampler::blank()). Phase-angle output switches every half-cycle,
+//     so there is no quiet time to keep to and its edges aren't blanked.
+//     Requires TC_ADC_INTERRUPT or TC_ADC_NOISE_SLEEP.
+#ifndef TC_ADC_BLANKING
+#define TC_ADC_BLANKING 0
+#endif
+
+// 1 = each LM19 sample comes with a reading of the 1.1 V bandgap against
+//     Vcc, and is scaled by how far Vcc has moved from where it was at
+//     power-on, so supply droop under the heater load stops reading as a
+//     temperature change. Relative to power-on so the bandgap's +/-10% part
+//     spread drops out. Costs VCC_SAMPLES (in the sketch) more conversions
+//     a sample. Requires TC_ADC_NOISE_SLEEP; pointless with
+//     TC_ADC_INTERNAL_REF, where the LM19 is off Vcc already.
+#ifndef TC_ADC_VCC_COMP
+#define TC_ADC_VCC_COMP 0
+#endif
+
+// ---------------- Filtering -------------------------------------------------
+// 1 = the LM19 is filtered by an alpha-beta estimator (see AlphaBetaFilter.h)
+//     that tracks the rate of change as well, instead of the EMA. It
+//     follows a warm-up or cool-down with no lag, and its rate drives
+//     TC_ADAPTIVE_SAMPLING. Requires TC_FIXED_POINT.
+#ifndef TC_ALPHA_BETA
+#define TC_ALPHA_BETA 0
+#endif
+
+// ---------------- Digital Outputs -------------------------------------------
+// 1 = SSR and status LEDs are driven straight through the port registers
+//     (see FastPin.h) instead of digitalWrite().
+#ifndef TC_FAST_PINS
+#define TC_FAST_PINS 1
+#endif
+
+// ---------------- Heater Output ---------------------------------------------
+// How the SSR is driven:
+#define TC_OUTPUT_HYSTERESIS        0   // on/off at the band edges, as originally written
+#define TC_OUTPUT_TIME_PROPORTIONAL 1   // slow PWM off Timer1 (see TimeProportionalOutput.h)
+#define TC_OUTPUT_PHASE_ANGLE       2   // triac phase angle off a zero-cross input (see PhaseAngleOutput.h)
+#ifndef TC_OUTPUT_MODE
+#define TC_OUTPUT_MODE TC_OUTPUT_HYSTERESIS
+#endif
+
+// 1 = the heater duty comes from an integer PID controller (see
+//     PidController.h) instead of the position in the hysteresis band.
+//     Needs a proportional TC_OUTPUT_MODE.
+#ifndef TC_CONTROL_PID
+#define TC_CONTROL_PID 0
+#endif
+
+// 1 = booting with the pot turned fully up runs a relay-feedback autotune
+//     (see RelayAutotune.h) and keeps the PID gains it finds in EEPROM.
+//     Requires TC_CONTROL_PID.
+#ifndef TC_AUTOTUNE
+#define TC_AUTOTUNE 0
+#endif
+
+// 1 = predictive cut-off: the hysteresis control learns how far the box
+//     coasts past each heater switch (see OvershootPredictor.h), turns the
+//     heater off early by half the coast after turn-off, and back on as
+//     much late; it keeps what it learned in EEPROM. The peaks come down by
+//     about half the coast and the SSR switches no more often than plain
+//     hysteresis; the swing stays about the same, so the mean sits a little
+//     below the set-point. Needs TC_OUTPUT_HYSTERESIS and TC_FIXED_POINT.
+#ifndef TC_PREDICTIVE_CUTOFF
+#define TC_PREDICTIVE_CUTOFF 0
+#endif
+
+// ---------------- Zones -----------------------------------------------------
+// 2 = run a second heated zone (e.g. the other shelf of the dryer) off its
+//     own LM19 on ZONE2_TEMP_PIN and its own SSR on ZONE2_SSR_PIN, at the
+//     pot's set-point plus ZONE2_OFFSET_F (see ControlZone.h). It is on/off
+//     only and has no LEDs; the 84A has no pins left for them. The filter
+//     and sampling options are the first zone's alone: the second always
+//     runs the plain EMA at the full rate. Requires TC_COUNT_THRESHOLDS and
+//     TC_OUTPUT_HYSTERESIS (both zones on/off), and TC_ADC_NOISE_SLEEP if
+//     TC_ADC_INTERRUPT is on.
+// 1 = one zone, as originally written.
+#ifndef TC_ZONES
+#define TC_ZONES 1
+#endif
+
+// ---------------- Safety ----------------------------------------------------
+// 1 = check every raw LM19 reading for a failed sensor: on a rail, moving
+//     faster than the box can, or stuck with the heater on full (see
+//     SensorFault.h). On a fault the sampling task shuts the heater off
+//     there and then, and the LEDs flash orange + blue / green until the
+//     readings are good again. Requires TC_FIXED_POINT.
+#ifndef TC_SENSOR_FAULT
+#define TC_SENSOR_FAULT 1
+#endif
+
+// 1 = the hardware watchdog resets the chip if loop() stops coming round
+//     for WATCHDOG_TIMEOUT (in the sketch); the reset leaves the SSR off.
+//     TC_SLEEP_POWER_DOWN has the watchdog for its wake-up timer, so the
+//     two don't go together.
+#ifndef TC_WATCHDOG
+#define TC_WATCHDOG 1
+#endif
+
+// ---------------- History --------------------------------------------------
+// 1 = keep a history of temperature, set-point and heater duty in a
+//     circular log in EEPROM (see EepromLog.h). Requires TC_FIXED_POINT.
+#ifndef TC_EEPROM_LOG
+#define TC_EEPROM_LOG 1
+#endif
+
+// 1 = stream a small binary status frame out of TELEMETRY_PIN as TX-only
+//     serial (see TelemetryTx.h). Requires TC_FIXED_POINT.
+#ifndef TC_TELEMETRY
+#define TC_TELEMETRY 0
+#endif
+
+// ---------------- Profiling -------------------------------------------------
+// 1 = time each task and each pass of loop() in CPU cycles (see
+//     TaskProfiler.h) and report min/max/average over TC_TELEMETRY. Costs
+//     ~130 bytes of RAM, so leave it off in normal use. Requires TC_TELEMETRY.
+#ifndef TC_PROFILE
+#define TC_PROFILE 0
+#endif
+
+// ---------------- Idle Between Tasks ----------------------------------------
+// What loop() does while no task is due (see IdleSleep.h):
+#define TC_SLEEP_NONE       0   // busy-poll, as originally written
+#define TC_SLEEP_IDLE       1   // idle sleep; timers and ADC keep running
+#define TC_SLEEP_POWER_DOWN 2   // power-down, woken by the watchdog
+#ifndef TC_IDLE_SLEEP
+#define TC_IDLE_SLEEP TC_SLEEP_IDLE
+#endif
+
+// ---------------- Option Checks ---------------------------------------------
+#if TC_APP != TC_APP_WOOD_DRYER && TC_APP != TC_APP_BREAD_PROOFER && TC_APP != TC_APP_BENCH
+#error "TC_APP must be one of the TC_APP_ profiles"
+#endif
+#if TC_COUNT_THRESHOLDS && !TC_FIXED_POINT
+#error "TC_COUNT_THRESHOLDS requires TC_FIXED_POINT"
+#endif
+#if TC_ADC_INTERRUPT && !TC_FIXED_POINT
+#error "TC_ADC_INTERRUPT requires TC_FIXED_POINT"
+#endif
+#if TC_ADC_NOISE_SLEEP && !TC_FIXED_POINT
+#error "TC_ADC_NOISE_SLEEP requires TC_FIXED_POINT"
+#endif
+#if TC_ADC_DECIMATE && !TC_ADC_INTERRUPT
+#error "TC_ADC_DECIMATE requires TC_ADC_INTERRUPT"
+#endif
+#if TC_ADC_DECIMATE && TC_ADC_NOISE_SLEEP
+#error "TC_ADC_DECIMATE takes the LM19 from the background sampler; turn TC_ADC_NOISE_SLEEP off"
+#endif
+#if TC_ADAPTIVE_SAMPLING && !TC_FIXED_POINT
+#error "TC_ADAPTIVE_SAMPLING requires TC_FIXED_POINT"
+#endif
+#if TC_ADAPTIVE_SAMPLING && TC_ADC_INTERRUPT && !TC_ADC_NOISE_SLEEP
+#error "TC_ADAPTIVE_SAMPLING can't pace the background sampler; turn TC_ADC_NOISE_SLEEP on"
+#endif
+#if TC_ADC_BLANKING && !TC_ADC_INTERRUPT && !TC_ADC_NOISE_SLEEP
+#error "TC_ADC_BLANKING blanks AdcSampler; it needs TC_ADC_INTERRUPT or TC_ADC_NOISE_SLEEP"
+#endif
+#if TC_ADC_VCC_COMP && !TC_ADC_NOISE_SLEEP
+#error "TC_ADC_VCC_COMP reads the bandgap with the LM19 in noise-reduction sleep; it needs TC_ADC_NOISE_SLEEP"
+#endif
+#if TC_ADC_VCC_COMP && TC_ADC_INTERNAL_REF
+#error "TC_ADC_INTERNAL_REF reads the LM19 off the bandgap already; turn TC_ADC_VCC_COMP off"
+#endif
+#if TC_ALPHA_BETA && !TC_FIXED_POINT
+#error "TC_ALPHA_BETA requires TC_FIXED_POINT"
+#endif
+#if TC_IDLE_SLEEP == TC_SLEEP_POWER_DOWN && TC_ADC_INTERRUPT
+#error "TC_SLEEP_POWER_DOWN stops Timer0, which paces TC_ADC_INTERRUPT sampling"
+#endif
+#if TC_OUTPUT_MODE == TC_OUTPUT_TIME_PROPORTIONAL && !TC_FIXED_POINT
+#error "TC_OUTPUT_TIME_PROPORTIONAL requires TC_FIXED_POINT"
+#endif
+#if TC_OUTPUT_MODE == TC_OUTPUT_TIME_PROPORTIONAL && TC_IDLE_SLEEP == TC_SLEEP_POWER_DOWN
+#error "TC_SLEEP_POWER_DOWN stops Timer1, which times TC_OUTPUT_TIME_PROPORTIONAL"
+#endif
+#if TC_OUTPUT_MODE == TC_OUTPUT_PHASE_ANGLE && !TC_FIXED_POINT
+#error "TC_OUTPUT_PHASE_ANGLE requires TC_FIXED_POINT"
+#endif
+#if TC_OUTPUT_MODE == TC_OUTPUT_PHASE_ANGLE && TC_IDLE_SLEEP == TC_SLEEP_POWER_DOWN
+#error "TC_SLEEP_POWER_DOWN stops Timer1, which times TC_OUTPUT_PHASE_ANGLE"
+#endif
+#if TC_OUTPUT_MODE == TC_OUTPUT_PHASE_ANGLE && TC_ADC_NOISE_SLEEP
+#error "TC_ADC_NOISE_SLEEP stops Timer1, which times TC_OUTPUT_PHASE_ANGLE; turn it off"
+#endif
+#if TC_CONTROL_PID && TC_OUTPUT_MODE == TC_OUTPUT_HYSTERESIS
+#error "TC_CONTROL_PID needs a proportional TC_OUTPUT_MODE"
+#endif
+#if TC_AUTOTUNE && !TC_CONTROL_PID
+#error "TC_AUTOTUNE requires TC_CONTROL_PID"
+#endif
+#if TC_PREDICTIVE_CUTOFF && !TC_FIXED_POINT
+#error "TC_PREDICTIVE_CUTOFF requires TC_FIXED_POINT"
+#endif
+#if TC_PREDICTIVE_CUTOFF && TC_OUTPUT_MODE != TC_OUTPUT_HYSTERESIS
+#error "TC_PREDICTIVE_CUTOFF is for on/off control; it needs TC_OUTPUT_HYSTERESIS"
+#endif
+#if TC_ZONES != 1 && TC_ZONES != 2
+#error "TC_ZONES must be 1 or 2"
+#endif
+#if TC_ZONES == 2 && !TC_COUNT_THRESHOLDS
+#error "TC_ZONES = 2 requires TC_COUNT_THRESHOLDS"
+#endif
+#if TC_ZONES == 2 && TC_OUTPUT_MODE != TC_OUTPUT_HYSTERESIS
+#error "TC_ZONES = 2 runs both zones on/off; it needs TC_OUTPUT_HYSTERESIS"
+#endif
+#if TC_ZONES == 2 && TC_ADC_INTERRUPT && !TC_ADC_NOISE_SLEEP
+#error "TC_ZONES = 2 reads the second LM19 in ADC Noise Reduction sleep; turn TC_ADC_NOISE_SLEEP on"
+#endif
+#if TC_SENSOR_FAULT && !TC_FIXED_POINT
+#error "TC_SENSOR_FAULT requires TC_FIXED_POINT"
+#endif
+#if TC_WATCHDOG && TC_IDLE_SLEEP == TC_SLEEP_POWER_DOWN
+#error "TC_SLEEP_POWER_DOWN runs the watchdog as its wake-up timer; turn TC_WATCHDOG off"
+#endif
+#if TC_EEPROM_LOG && !TC_FIXED_POINT
+#error "TC_EEPROM_LOG requires TC_FIXED_POINT"
+#endif
+#if TC_TELEMETRY && !TC_FIXED_POINT
+#error "TC_TELEMETRY requires TC_FIXED_POINT"
+#endif
+#if TC_TELEMETRY && TC_IDLE_SLEEP == TC_SLEEP_POWER_DOWN
+#error "TC_SLEEP_POWER_DOWN stops Timer0, which clocks TC_TELEMETRY"
+#endif
+
+#if TC_PROFILE && !TC_TELEMETRY
+#error "TC_PROFILE reports through TC_TELEMETRY"
+#endif
+
+#endif // BUILD_OPTIONS_H
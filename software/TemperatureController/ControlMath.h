@@ -0,0 +1,73 @@
+#ifndef CONTROL_MATH_H
+#define CONTROL_MATH_H
+
+#include <Arduino.h>
+#include "AppProfile.h"
+#include "FixedTemp.h"
+
+/******************************************************************************
+ DESCRIPTION: This file is part of the Temperature Controller application.
+  The integer steps of the control pipeline, worked out from the TC_APP
+  profile: the pot reading to a set-point, a set-point to its band, and one
+  step of the Q8 EMA.
+
+ NOTES:
+  - The pot is read in half-counts (raw * 2) so the midpoint of 511.5 is
+    the whole number 1023; each half of the travel then maps to its
+    temperature span with a Q16 multiplier. The multipliers, like the other
+    constants here, are worked out by the compiler from APP.
+  - bandFor() is a template on the LM19 driver (see LM19.h), since the
+    band is in that driver's table-position units.
+  - BENCH_Controller has this file as a symlink, so the bench times the
+    very code the controller runs rather than a copy of it.
+  - Everything here is constexpr or inline, so like RingBuffer it lives
+    entirely in the header.
+*******************************************************************************/
+
+constexpr TempCF   MIN_SET_CF    = toCF(APP.minSetF);
+constexpr TempCF   MID_SET_CF    = toCF(APP.midSetF);
+constexpr TempCF   MAX_SET_CF    = toCF(APP.maxSetF);
+constexpr uint16_t POT_MID_HALF  = 1023;
+constexpr uint32_t POT_LO_CF_Q16 = (uint32_t)((MID_SET_CF - MIN_SET_CF) * 65536.0f / POT_MID_HALF + 0.5f);
+constexpr uint32_t POT_HI_CF_Q16 = (uint32_t)((MAX_SET_CF - MID_SET_CF) * 65536.0f / POT_MID_HALF + 0.5f);
+
+constexpr TempCF   HYST_CF       = toCF(APP.hystF);
+constexpr TempCF   HALF_BAND_CF  = HYST_CF / 2;
+constexpr uint8_t  TEMP_ALPHA_Q8 = (uint8_t)(APP.tempAlpha * 256.0f + 0.5f);
+
+static_assert(TEMP_ALPHA_Q8 > 0, "TEMP_ALPHA is too small for an 8-bit fraction");
+
+// Map a pot reading to a set-point in hundredths of a °F. Piecewise: the
+// bottom half of the pot spans the profile's minimum to its midpoint, the
+// top half the midpoint to its maximum. All integer, so the float build
+// uses it too.
+inline TempCF potToSetpointCF(uint16_t potRaw) {
+  uint16_t rawHalf = potRaw * 2;   // 0..2046, midpoint = 1023
+
+  if (rawHalf <= POT_MID_HALF) {
+    return MIN_SET_CF + (TempCF)((rawHalf * POT_LO_CF_Q16) >> 16);
+  } else {
+    return MID_SET_CF + (TempCF)(((rawHalf - POT_MID_HALF) * POT_HI_CF_Q16) >> 16);
+  }
+}
+
+// The band's on/set/off thresholds, as Sensor table positions, for a
+// set-point. The LM19 table run backwards (see Lm19Curve::cfToPos()); only
+// needed when the set-point changes, so the walk and the divide don't
+// matter.
+template <class Sensor>
+BandThresholds bandFor(TempCF setCF) {
+  return BandThresholds{
+    Sensor::cfToPos(setCF - HALF_BAND_CF),
+    Sensor::cfToPos(setCF),
+    Sensor::cfToPos(setCF + HALF_BAND_CF) };
+}
+
+// One EMA step: the filtered value moved alphaQ8/256 of the way to raw,
+// rounded to the nearest unit.
+inline int32_t emaStepQ8(int32_t filtered, int32_t raw, uint8_t alphaQ8) {
+  int32_t step = (raw - filtered) * alphaQ8 + 128;
+  return filtered + (step >> 8);
+}
+
+#endif // CONTROL_MATH_H
@@ -0,0 +1,121 @@
+#ifndef CONTROL_ZONE_H
+#define CONTROL_ZONE_H
+
+#include <Arduino.h>
+#include "FixedTemp.h"
+#include "ControlMath.h"
+
+/******************************************************************************
+ DESCRIPTION: This class is part of the Temperature Controller application.
+  One extra heated zone (e.g. the lower shelf of the dryer): its own LM19,
+  filter, set-point band and on/off SSR, fixed at compile time by a Zone
+  description.
+
+ NOTES:
+  - Zone is a struct of compile-time settings; the sketch's ShelfZone is
+    the example. It supplies:
+      * SsrPin: a FastPin for the zone's SSR.
+      * TEMP_MUX: the ADC channel its LM19 is on (for the sketch's reading
+        code; the zone itself takes readings, not channels).
+      * ALPHA_Q8: the EMA factor, as an 8-bit fraction.
+      * makeBand(setPointCF): the on/set/off thresholds, in the same LM19
+        table-position units the readings come in.
+  - Everything else comes from the template, so each zone is its own
+    class, with no virtual calls and no pointers to its settings. The RAM
+    per zone is the members below: 11 bytes.
+  - The zone runs the count-threshold hysteresis of the main pipeline:
+    counts fall as temperature rises, so heater on at/above onCounts, off
+    at/below offCounts (see BandThresholds in FixedTemp.h).
+  - Only that. The first zone's other pipeline options don't reach it: it
+    filters with the plain EMA whatever TC_ALPHA_BETA says, is sampled at
+    the full rate whatever TC_ADAPTIVE_SAMPLING does to the first, and
+    switches at the band edges without TC_PREDICTIVE_CUTOFF. There is no
+    float or TempCF path. BuildOptions.h only allows it beside an on/off
+    first zone (TC_OUTPUT_HYSTERESIS), so a PID or phase-angle zone never
+    runs next to it.
+  - What it does share: the ADC, the TC_ADC_BLANKING window (the sketch
+    calls ssrEdge() when its SSR switches) and the set-point. TC_SENSOR_FAULT
+    gives it a detector of its own, and a fault stops only this zone.
+  - The sketch's scheduler does the timing. sample() wants one new LM19
+    reading per call, and control() should be called once per control
+    period.
+  - This is a template, so like RingBuffer it lives entirely in the header.
+*******************************************************************************/
+
+template <class Zone>
+class ControlZone {
+  public:
+    typedef typename Zone::SsrPin SsrPin;
+
+    ControlZone()
+          :
+          _filteredCounts(0),
+          _setPointCF(0),
+          _band{0, 0, 0},
+          _heaterOn(false)
+          {}
+
+    // ---- General Methods ---------------------------------------------------
+
+    // Set up the SSR pin (heater off), and seed the filter and band from a
+    // first reading and set-point.
+    void begin(uint16_t pos, TempCF setPointCF) {
+      SsrPin::low();
+      SsrPin::output();
+      _heaterOn       = false;
+      _filteredCounts = pos;
+      _setPointCF     = setPointCF;
+      _band           = Zone::makeBand(setPointCF);
+    }
+
+    // Filter in one LM19 reading (a table position).
+    void sample(uint16_t pos) {
+      _filteredCounts = (uint16_t)emaStepQ8(_filteredCounts, pos, Zone::ALPHA_Q8);
+    }
+
+    // The on/off decision for this control period. Only writes the SSR when
+    // its state changes. Returns whether the heater is on.
+    bool control() {
+      bool wantOn = _heaterOn;   // default: keep current state (deadband)
+      if (_filteredCounts >= _band.onCounts) {
+        wantOn = true;           // too cold
+      } else if (_filteredCounts <= _band.offCounts) {
+        wantOn = false;          // too hot
+      }
+
+      if (wantOn != _heaterOn) {
+        _heaterOn = wantOn;
+        SsrPin::write(_heaterOn);
+      }
+      return _heaterOn;
+    }
+
+    // Heater off now, e.g. the zone's LM19 has failed. control() would turn
+    // it back on, so stop calling it until the readings are good again, and
+    // re-seed with begin() then.
+    void shutOff() {
+      _heaterOn = false;
+      SsrPin::low();
+    }
+
+    // ---- Setter/Getter Functions -------------------------------------------
+
+    // A new set-point; the band is only rebuilt if it differs.
+    void setSetPoint(TempCF setPointCF) {
+      if (setPointCF == _setPointCF) return;
+      _setPointCF = setPointCF;
+      _band       = Zone::makeBand(setPointCF);
+    }
+
+    uint16_t filteredCounts() const { return _filteredCounts; }
+    TempCF setPointCF() const       { return _setPointCF; }
+    bool heaterOn() const           { return _heaterOn; }
+
+  private:
+    uint16_t _filteredCounts;   // filtered LM19, table-position units
+    TempCF _setPointCF;
+    BandThresholds _band;
+    bool _heaterOn;
+};
+
+#endif // CONTROL_ZONE_H
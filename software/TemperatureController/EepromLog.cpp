@@ -0,0 +1,188 @@
+#include "EepromLog.h"
+#include <avr/eeprom.h>
+
+// seq runs 0..254 so that 0xFF only ever means "never written".
+static const uint8_t SEQ_EMPTY  = 0xFF;
+static const uint8_t SEQ_MODULO = 255;
+
+/******************************************************************************
+ DESCRIPTION: Hundredths of a °F to the log's half-°F, saturating at both
+  ends.
+*******************************************************************************/
+static uint8_t toHalfF(int32_t tempCF) {
+  if (tempCF <= 0) return 0;
+  int32_t halfF = (tempCF + 25) / 50;
+  return halfF > 255 ? 255 : (uint8_t)halfF;
+}
+
+/******************************************************************************
+ DESCRIPTION: Constructor, using initializer list.
+
+ NOTES:
+  - The log takes the EEPROM from startAddr up to (not including) endAddr,
+    in whole records.
+  - samplesPerRecord is how many sample() calls go into one record, and
+    minutesPerRecord how long that takes; it goes in each record's deltaMin.
+*******************************************************************************/
+EepromLog::EepromLog(uint16_t startAddr, uint16_t endAddr,
+                     uint16_t samplesPerRecord, uint8_t minutesPerRecord)
+      :
+      _startAddr(startAddr),
+      _slots((uint8_t)((endAddr - startAddr) / RECORD_SIZE)),
+      _head(0),
+      _count(0),
+      _nextSeq(0),
+      _first(true),
+      _minutesPerRecord(minutesPerRecord),
+      _samplesPerRecord(samplesPerRecord),
+      _samples(0),
+      _tempSum(0),
+      _setPointSum(0),
+      _dutySum(0),
+      _queued(0),
+      _writeIndex(0),
+      _flushing(false)
+      {}
+
+/******************************************************************************
+ DESCRIPTION: Find where the log left off: follow the run of consecutive
+  seq numbers from slot 0 to the newest record.
+
+ NOTES:
+  - A blank slot ends the run too; then the log has not wrapped yet.
+  - Reads the whole log area once (under 1 ms), so call it from setup().
+*******************************************************************************/
+void EepromLog::begin() {
+  LogRecord record;
+
+  _head    = 0;
+  _count   = 0;
+  _nextSeq = 0;
+  if (!readSlot(0, record)) return;   // empty log
+
+  uint8_t newest = 0;
+  uint8_t seq    = record.seq;
+  while (newest + 1 < _slots && readSlot(newest + 1, record) &&
+         record.seq == (seq + 1) % SEQ_MODULO) {
+    newest++;
+    seq = record.seq;
+  }
+
+  _head    = (newest + 1) % _slots;
+  _nextSeq = (seq + 1) % SEQ_MODULO;
+  _count   = readSlot(_head, record) ? _slots : newest + 1;
+}
+
+/******************************************************************************
+ DESCRIPTION: Add one sample to the record being built; closes the record
+  once it has samplesPerRecord of them.
+*******************************************************************************/
+void EepromLog::sample(TempCF temperature, TempCF setPoint, uint8_t duty) {
+  _tempSum     += temperature;
+  _setPointSum += setPoint;
+  _dutySum     += duty;
+
+  if (++_samples >= _samplesPerRecord) {
+    closeRecord();
+  }
+}
+
+/******************************************************************************
+ DESCRIPTION: Turn the running sums into a record and queue it. When a full
+  batch is queued, service() starts writing it out.
+
+ NOTES:
+  - A record finished while the previous batch is still being written is
+    dropped. At one byte per control period that takes 15 s, against
+    records minutes apart.
+*******************************************************************************/
+void EepromLog::closeRecord() {
+  if (!_flushing && _queued < BATCH_RECORDS) {
+    LogRecord& record = _batch[_queued++];
+
+    record.seq           = _nextSeq;
+    record.deltaMin      = _first ? 0 : _minutesPerRecord;
+    record.tempHalfF     = toHalfF(_tempSum / _samples);
+    record.setPointHalfF = toHalfF(_setPointSum / _samples);
+    record.duty          = (uint8_t)(_dutySum / _samples);
+
+    _nextSeq = (_nextSeq + 1) % SEQ_MODULO;
+    _first   = false;
+
+    if (_queued == BATCH_RECORDS) {
+      _flushing   = true;
+      _writeIndex = 0;
+    }
+  }
+
+  _samples     = 0;
+  _tempSum     = 0;
+  _setPointSum = 0;
+  _dutySum     = 0;
+}
+
+/******************************************************************************
+ DESCRIPTION: Write the next byte of the queued batch, if there is one and
+  the EEPROM has finished the last. Call it often (e.g. every sample()).
+
+ NOTES:
+  - Each record goes out as bytes 1..4 and then byte 0 (seq); see the
+    class notes for why.
+*******************************************************************************/
+void EepromLog::service() {
+  if (!_flushing || !eeprom_is_ready()) return;
+
+  uint8_t recordIndex = _writeIndex / RECORD_SIZE;
+  uint8_t byteIndex   = _writeIndex % RECORD_SIZE;
+  uint8_t offset      = (byteIndex + 1) % RECORD_SIZE;   // seq last
+  const uint8_t* src  = (const uint8_t*)&_batch[recordIndex];
+
+  eeprom_update_byte((uint8_t*)(uintptr_t)(slotAddr(_head) + offset), src[offset]);
+
+  if (byteIndex == RECORD_SIZE - 1) {
+    _head = (_head + 1) % _slots;
+    if (_count < _slots) _count++;
+  }
+  if (++_writeIndex == _queued * RECORD_SIZE) {
+    _flushing = false;
+    _queued   = 0;
+  }
+}
+
+/******************************************************************************
+ DESCRIPTION: Read back a record: age 0 is the newest in EEPROM, age
+  count()-1 the oldest. Returns false past the end of the log.
+
+ NOTES:
+  - Records still queued in RAM are not included.
+  - Reading waits for any EEPROM write in progress. This is for dumping
+    the log, not for the control path.
+*******************************************************************************/
+bool EepromLog::read(uint8_t age, LogRecord& record) const {
+  if (age >= _count) return false;
+  uint8_t slot = (uint8_t)((_head + _slots - 1 - age) % _slots);
+  return readSlot(slot, record);
+}
+
+/******************************************************************************
+ DESCRIPTION: Read a slot. Returns false if it has never been written.
+*******************************************************************************/
+bool EepromLog::readSlot(uint8_t slot, LogRecord& record) const {
+  eeprom_read_block(&record, (const void*)(uintptr_t)slotAddr(slot), RECORD_SIZE);
+  return record.seq != SEQ_EMPTY;
+}
+
+uint16_t EepromLog::slotAddr(uint8_t slot) const {
+  return _startAddr + (uint16_t)slot * RECORD_SIZE;
+}
+
+/******************************************************************************
+ DESCRIPTION: Getter methods
+*******************************************************************************/
+uint8_t EepromLog::slots() const {
+  return _slots;
+}
+
+uint8_t EepromLog::count() const {
+  return _count;
+}
@@ -0,0 +1,97 @@
+#ifndef EEPROM_LOG_H
+#define EEPROM_LOG_H
+
+#include <Arduino.h>
+#include "FixedTemp.h"
+
+/******************************************************************************
+ DESCRIPTION: One packed history record, 5 bytes as stored in EEPROM.
+
+ NOTES:
+  - seq counts up by one per record, 0..254 and round again; it is how
+    begin() finds the newest record after a reboot. 0xFF marks a slot that
+    has never been written.
+  - deltaMin is the minutes since the previous record. 0 marks the first
+    record after a power-up.
+  - Temperatures are averages over the record's interval, in half-°F from
+    0 °F (so 0..127.5 °F), which is plenty for a history.
+  - duty is the heater's average share of full power over the interval,
+    0..255; for on/off control that is simply its on-time fraction.
+*******************************************************************************/
+struct LogRecord {
+  uint8_t seq;
+  uint8_t deltaMin;
+  uint8_t tempHalfF;
+  uint8_t setPointHalfF;
+  uint8_t duty;
+};
+
+/******************************************************************************
+ DESCRIPTION: This class is part of the Temperature Controller application.
+  It keeps a history of temperature, set-point and heater duty in a
+  circular log in EEPROM, so we can see afterwards what happened overnight.
+
+ NOTES:
+  - sample() is called at a steady rate and adds to running sums in RAM;
+    every samplesPerRecord samples those become one averaged record.
+  - Wear-leveling: records go round the whole log area in turn, so each
+    EEPROM byte is written once per lap. At 99 slots and a record every 10
+    minutes a lap is ~16 hours, which puts the 100,000-write rating a couple
+    of centuries away.
+  - Records are queued in RAM and written in batches of BATCH_RECORDS. An
+    EEPROM byte write takes ~3.3 ms, and avr-libc's write routines wait for
+    the previous one, so service() writes at most one byte per call and only
+    when the EEPROM is idle. Nothing ever waits on the EEPROM.
+  - The queued batch is lost if the power goes; that is up to
+    BATCH_RECORDS intervals of history.
+  - Each record's seq byte is written last. A record torn by a power cut
+    keeps its old seq byte, so it reads as a (garbled) old record rather
+    than upsetting which one is newest.
+*******************************************************************************/
+
+class EepromLog {
+  public:
+    static const uint8_t RECORD_SIZE   = sizeof(LogRecord);
+    static const uint8_t BATCH_RECORDS = 3;
+
+    EepromLog(uint16_t startAddr, uint16_t endAddr,
+              uint16_t samplesPerRecord, uint8_t minutesPerRecord);
+
+    // ---- General Methods ---------------------------------------------------
+    void begin();
+    void sample(TempCF temperature, TempCF setPoint, uint8_t duty);
+    void service();
+    bool read(uint8_t age, LogRecord& record) const;
+
+    // ---- Setter/Getter Functions -------------------------------------------
+    uint8_t slots() const;
+    uint8_t count() const;
+
+  private:
+    uint16_t slotAddr(uint8_t slot) const;
+    bool readSlot(uint8_t slot, LogRecord& record) const;
+    void closeRecord();
+
+    uint16_t _startAddr;
+    uint8_t _slots;
+    uint8_t _head;               // next slot to write
+    uint8_t _count;              // valid records in EEPROM
+    uint8_t _nextSeq;
+    bool _first;                 // no record yet since power-up
+    uint8_t _minutesPerRecord;
+    uint16_t _samplesPerRecord;
+
+    // Running sums for the record being built
+    uint16_t _samples;
+    int32_t _tempSum;
+    int32_t _setPointSum;
+    uint32_t _dutySum;
+
+    // Finished records waiting to be written, and how far that has got
+    LogRecord _batch[BATCH_RECORDS];
+    uint8_t _queued;
+    uint8_t _writeIndex;         // byte of the batch to write next
+    bool _flushing;
+};
+
+#endif // EEPROM_LOG_H
@@ -0,0 +1,46 @@
+#include "EepromRecord.h"
+#include <avr/eeprom.h>
+
+/******************************************************************************
+ DESCRIPTION: Check byte over the tag and data. Starting from a non-zero
+  seed means an all-zero EEPROM does not pass either.
+*******************************************************************************/
+static uint8_t recordCheck(uint8_t tag, const uint8_t* data, uint8_t size) {
+  uint8_t check = 0xA5 ^ tag;
+  for (uint8_t i = 0; i < size; i++) {
+    check = (uint8_t)((check << 1) | (check >> 7)) ^ data[i];
+  }
+  return check;
+}
+
+/******************************************************************************
+ DESCRIPTION: Read the record at addr into data. Returns false, and leaves
+  data alone, if the tag does not match or the record fails its check.
+*******************************************************************************/
+bool eepromLoadRecord(uint16_t addr, uint8_t tag, void* data, uint8_t size) {
+  uint8_t buf[16];
+  if (size > sizeof(buf)) return false;
+
+  const uint8_t* ee = (const uint8_t*)(uintptr_t)addr;
+  if (eeprom_read_byte(ee) != tag) return false;
+
+  eeprom_read_block(buf, ee + 1, size);
+  if (eeprom_read_byte(ee + 1 + size) != recordCheck(tag, buf, size)) return false;
+
+  memcpy(data, buf, size);
+  return true;
+}
+
+/******************************************************************************
+ DESCRIPTION: Write data as the record at addr. The tag goes last, so a save
+  cut short leaves either the old tag with a mismatched check, or no tag:
+  both read back as "no record".
+*******************************************************************************/
+void eepromSaveRecord(uint16_t addr, uint8_t tag, const void* data, uint8_t size) {
+  uint8_t* ee = (uint8_t*)(uintptr_t)addr;
+
+  eeprom_update_byte(ee, 0xFF);   // invalidate while the data is in flux
+  eeprom_update_block(data, ee + 1, size);
+  eeprom_update_byte(ee + 1 + size, recordCheck(tag, (const uint8_t*)data, size));
+  eeprom_update_byte(ee, tag);
+}
@@ -0,0 +1,37 @@
+#ifndef EEPROM_RECORD_H
+#define EEPROM_RECORD_H
+
+#include <Arduino.h>
+
+/******************************************************************************
+ DESCRIPTION: Small checked records in the ATtiny84A's 512 bytes of EEPROM,
+  for settings the controller learns and should keep across power cycles.
+
+ NOTES:
+  - A record is laid out as [tag][data ...][check], so it takes the data
+    size plus 2 bytes. The tag says what the record is (and which version of
+    its layout); the check byte catches a blank EEPROM (all 0xFF), a record
+    torn by a power cut part-way through saving, and stale layouts.
+  - Saving only writes the bytes that actually changed, but each byte that
+    does change blocks for about 3.3 ms. Keep it out of anything that runs
+    often.
+  - Where each record lives is set in the EEPROM Layout section below, so
+    that all users of the EEPROM are listed in one place.
+*******************************************************************************/
+
+// ---------------- EEPROM Layout ---------------------------------------------
+// address                       size  what
+// 0                             8     PID gains (TC_CONTROL_PID, TC_AUTOTUNE)
+// 8                             6     coast leads (TC_PREDICTIVE_CUTOFF)
+// 16 .. 511                     496   history log (TC_EEPROM_LOG, see EepromLog.h)
+const uint16_t EE_PID_GAINS_ADDR = 0;
+const uint8_t  EE_TAG_PID_GAINS  = 0x51;  // bump when PidGains changes
+const uint16_t EE_LEADS_ADDR     = 8;
+const uint8_t  EE_TAG_LEADS      = 0x61;  // bump when OvershootLeads changes
+const uint16_t EE_LOG_START      = 16;
+const uint16_t EE_LOG_END        = 512;   // ATtiny84A EEPROM size
+
+bool eepromLoadRecord(uint16_t addr, uint8_t tag, void* data, uint8_t size);
+void eepromSaveRecord(uint16_t addr, uint8_t tag, const void* data, uint8_t size);
+
+#endif // EEPROM_RECORD_H
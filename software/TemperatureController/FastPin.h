@@ -0,0 +1,60 @@
+#ifndef FAST_PIN_H
+#define FAST_PIN_H
+
+#include <Arduino.h>
+
+/******************************************************************************
+ DESCRIPTION: Compile-time digital output pins for the ATtiny84A, driven
+  straight through the port registers instead of digitalWrite().
+
+ NOTES:
+  - digitalWrite() has to look the pin up in a table and guard against
+    interrupts each time, which costs dozens of cycles. Here the port and
+    bit are template parameters, so high()/low() compile down to a single
+    sbi/cbi instruction (which is also atomic, so no interrupt guard needed).
+  - Usage:  typedef FastPin<PortB, 0> SsrPin;   SsrPin::output();  SsrPin::high();
+  - The ATtiny84A only has PORTA and PORTB.
+  - Nothing checks that a FastPin matches the Arduino pin number used
+    elsewhere; keep them side by side in the sketch so they stay in step.
+*******************************************************************************/
+
+struct PortA {
+  static volatile uint8_t& out() { return PORTA; }
+  static volatile uint8_t& ddr() { return DDRA; }
+  static volatile uint8_t& in()  { return PINA; }
+};
+
+struct PortB {
+  static volatile uint8_t& out() { return PORTB; }
+  static volatile uint8_t& ddr() { return DDRB; }
+  static volatile uint8_t& in()  { return PINB; }
+};
+
+template <class P, uint8_t Bit>
+struct FastPin {
+  static_assert(Bit < 8, "FastPin bit must be 0..7");
+
+  typedef P Port;
+  static const uint8_t MASK = (uint8_t)(1 << Bit);
+
+  static void output()          { P::ddr() |= MASK; }
+  static void high()            { P::out() |= MASK; }
+  static void low()             { P::out() &= (uint8_t)~MASK; }
+  static void write(bool on)    { if (on) high(); else low(); }
+  static bool isHigh()          { return (P::out() & MASK) != 0; }
+};
+
+/******************************************************************************
+ DESCRIPTION: Mask of the bits in port P used by up to three FastPins.
+  Pins on other ports contribute nothing, so this works out at compile time
+  which LEDs share a port.
+*******************************************************************************/
+template <class A, class B> struct SamePort       { static const bool value = false; };
+template <class A>          struct SamePort<A, A> { static const bool value = true; };
+
+template <class P, class Pin>
+struct PortMask {
+  static const uint8_t value = SamePort<P, typename Pin::Port>::value ? Pin::MASK : 0;
+};
+
+#endif // FAST_PIN_H
@@ -0,0 +1,42 @@
+#ifndef FIXED_TEMP_H
+#define FIXED_TEMP_H
+
+#include <Arduino.h>
+
+/******************************************************************************
+ DESCRIPTION: Fixed-point temperature type shared by the modules of the
+  Temperature Controller application.
+
+ NOTES:
+  - TempCF holds a temperature in hundredths of a degree Fahrenheit
+    ("centi-°F"), so 72.5 °F is stored as 7250. An int16_t covers
+    -327.68 .. +327.67 °F, far more than the LM19 can report.
+  - toCF() is constexpr. Use it only on constants so the conversion is done
+    by the compiler; calling it on a runtime float would pull the soft-float
+    library right back in.
+*******************************************************************************/
+
+typedef int16_t TempCF;
+
+constexpr TempCF toCF(float tempF) {
+  return (TempCF)(tempF * 100.0f + (tempF >= 0.0f ? 0.5f : -0.5f));
+}
+
+/******************************************************************************
+ DESCRIPTION: The hysteresis band around the set-point, expressed in the same
+  units as the filtered LM19 reading (scaled ADC counts) instead of degrees.
+
+ NOTES:
+  - The LM19 output voltage FALLS as temperature rises, so a larger count
+    means a colder reading: onCounts > setCounts > offCounts.
+  - onCounts  = reading at (set-point - half band): heater turns on at/above.
+  - setCounts = reading at the set-point itself.
+  - offCounts = reading at (set-point + half band): heater turns off at/below.
+*******************************************************************************/
+struct BandThresholds {
+  uint16_t onCounts;
+  uint16_t setCounts;
+  uint16_t offCounts;
+};
+
+#endif // FIXED_TEMP_H
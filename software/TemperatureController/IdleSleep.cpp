@@ -0,0 +1,154 @@
+#include "IdleSleep.h"
+#include <avr/sleep.h>
+#if TC_IDLE_SLEEP == TC_SLEEP_POWER_DOWN
+#include <avr/pgmspace.h>
+#include <avr/wdt.h>
+#endif
+
+static const unsigned long DUTY_WINDOW_US = 10000000UL;   // ~10 s
+
+/******************************************************************************
+ DESCRIPTION: Constructor, using initializer list.
+*******************************************************************************/
+IdleSleep::IdleSleep()
+      :
+      _sleptMs(0),
+      _lastWakeUs(0),
+      _awakeUs(0),
+      _asleepUs(0),
+      _dutyPermille(1000)
+      {}
+
+/******************************************************************************
+ DESCRIPTION: Call this at the end of setup(), so the boot-up time does not
+  count against the first duty-cycle window.
+*******************************************************************************/
+void IdleSleep::begin() {
+  _lastWakeUs = micros();
+}
+
+/******************************************************************************
+ DESCRIPTION: Sleep for about idleMs milliseconds, then return so loop() can
+  run the scheduler again. Pass it what TaskScheduler::runDue() returned.
+
+ NOTES:
+  - Power-down is used in whole watchdog periods while at least 16 ms is
+    left; anything shorter is slept off in idle mode.
+  - Idle sleep is woken by every millis() tick. Those few-microsecond ISRs
+    are counted as asleep, which flatters the duty cycle by roughly 0.3%.
+  - Idle sleep can overrun by up to one millis() tick (~2 ms).
+*******************************************************************************/
+void IdleSleep::idle(unsigned long idleMs) {
+  unsigned long idleUs = 0;
+  unsigned long powerDownUs = 0;
+
+#if TC_IDLE_SLEEP == TC_SLEEP_POWER_DOWN
+  while (idleMs >= 16) {
+    uint16_t ms = powerDown(idleMs);
+    _sleptMs    += ms;
+    powerDownUs += ms * 1000UL;
+    idleMs      -= ms;
+  }
+#endif
+
+#if TC_IDLE_SLEEP != TC_SLEEP_NONE
+  if (idleMs > 0) {
+    const unsigned long startMs = millis();
+    const unsigned long startUs = micros();
+
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    while (millis() - startMs < idleMs) {
+      sleep_enable();
+      sleep_cpu();
+      sleep_disable();
+    }
+    idleUs = micros() - startUs;
+  }
+#else
+  (void)idleMs;
+#endif
+
+  account(idleUs, powerDownUs);
+}
+
+/******************************************************************************
+ DESCRIPTION: Application clock: millis() plus any time spent powered down.
+  Without TC_SLEEP_POWER_DOWN this is just millis().
+*******************************************************************************/
+unsigned long IdleSleep::now() const {
+  return millis() + _sleptMs;
+}
+
+/******************************************************************************
+ DESCRIPTION: Add one awake stretch and one sleep to the duty-cycle window,
+  and close the window once it is ~10 s long.
+
+ NOTES:
+  - The awake stretch is everything micros() has seen since we last came out
+    of idle(), less the idle sleep (which micros() also saw). micros() does
+    not run during power-down, so that time is only ever added as sleep.
+*******************************************************************************/
+void IdleSleep::account(unsigned long idleUs, unsigned long powerDownUs) {
+  unsigned long nowUs = micros();
+
+  _awakeUs   += (nowUs - _lastWakeUs) - idleUs;
+  _asleepUs  += idleUs + powerDownUs;
+  _lastWakeUs = nowUs;
+
+  unsigned long totalUs = _awakeUs + _asleepUs;
+  if (totalUs >= DUTY_WINDOW_US) {
+    _dutyPermille = (uint16_t)(_awakeUs / (totalUs / 1000));
+    _awakeUs  = 0;
+    _asleepUs = 0;
+  }
+}
+
+/******************************************************************************
+ DESCRIPTION: Getter methods
+*******************************************************************************/
+uint16_t IdleSleep::dutyPermille() const {
+  return _dutyPermille;
+}
+
+#if TC_IDLE_SLEEP == TC_SLEEP_POWER_DOWN
+/******************************************************************************
+ DESCRIPTION: Power down for the longest watchdog period that fits in maxMs
+  (which must be at least 16). Returns the nominal period slept, in ms.
+*******************************************************************************/
+uint16_t IdleSleep::powerDown(unsigned long maxMs) {
+  static const uint16_t WDT_PERIOD_MS[] PROGMEM = {
+    16, 32, 64, 125, 250, 500, 1000, 2000, 4000, 8000 };
+
+  uint8_t wdp = 9;
+  while (wdp > 0 && pgm_read_word(&WDT_PERIOD_MS[wdp]) > maxMs) wdp--;
+
+  // Watchdog in interrupt-only mode: wake us, don't reset us
+  uint8_t wdtBits = _BV(WDIE) | (wdp & 0x07) | ((wdp & 0x08) ? _BV(WDP3) : 0);
+  cli();
+  wdt_reset();
+  MCUSR &= ~_BV(WDRF);
+  WDTCSR = _BV(WDCE) | _BV(WDE);
+  WDTCSR = wdtBits;
+
+  set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+  sleep_enable();
+#ifdef sleep_bod_disable
+  sleep_bod_disable();
+#endif
+  sei();
+  sleep_cpu();
+  sleep_disable();
+
+  // Watchdog back off until next time
+  cli();
+  WDTCSR = _BV(WDCE) | _BV(WDE);
+  WDTCSR = 0;
+  sei();
+
+  return pgm_read_word(&WDT_PERIOD_MS[wdp]);
+}
+
+ISR(WDT_vect) {
+  // Nothing to do; waking up was the point.
+}
+#endif
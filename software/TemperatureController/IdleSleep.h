@@ -0,0 +1,52 @@
+#ifndef IDLE_SLEEP_H
+#define IDLE_SLEEP_H
+
+#include <Arduino.h>
+#include "BuildOptions.h"
+
+/******************************************************************************
+ DESCRIPTION: This class is part of the Temperature Controller application.
+  It puts the ATtiny to sleep between scheduled tasks instead of letting
+  loop() spin, and keeps track of how much of the time the CPU is awake.
+
+ NOTES:
+  - The sleep mode is chosen with TC_IDLE_SLEEP in BuildOptions.h:
+      * TC_SLEEP_NONE: original busy loop; idle() returns at once.
+      * TC_SLEEP_IDLE: CPU clock stops, timers keep running. The millis()
+        tick (about every 2 ms) and the ADC interrupt wake us. idle() goes
+        back to sleep until the time it was given has passed.
+      * TC_SLEEP_POWER_DOWN: everything stops except the watchdog, which
+        wakes us after 16 ms .. 8 s. millis() does NOT advance while powered
+        down, so use now() as the application clock: it is millis() plus the
+        time spent powered down. The watchdog oscillator is only good to
+        about 10%, so task timing is too.
+  - dutyPermille() is the awake share of the last measuring window
+    (~10 s) in parts per thousand: 1000 = never sleeps, 5 = awake 0.5%.
+*******************************************************************************/
+
+class IdleSleep {
+  public:
+    IdleSleep();
+
+    // ---- General Methods ---------------------------------------------------
+    void begin();
+    void idle(unsigned long idleMs);
+    unsigned long now() const;
+
+    // ---- Setter/Getter Functions -------------------------------------------
+    uint16_t dutyPermille() const;
+
+  private:
+    void account(unsigned long idleUs, unsigned long powerDownUs);
+#if TC_IDLE_SLEEP == TC_SLEEP_POWER_DOWN
+    uint16_t powerDown(unsigned long maxMs);
+#endif
+
+    unsigned long _sleptMs;      // power-down time not seen by millis()
+    unsigned long _lastWakeUs;   // micros() when we last came out of idle()
+    unsigned long _awakeUs;      // this window
+    unsigned long _asleepUs;     // this window
+    uint16_t _dutyPermille;      // result of the last finished window
+};
+
+#endif // IDLE_SLEEP_H
@@ -0,0 +1,141 @@
+#include "OvershootPredictor.h"
+
+// Limits that keep the Q12 products below inside 32 bits. Neither is near a
+// real coast or rate; they only stop a wild reading from wrapping round.
+static const int32_t MAX_COAST   = 0x7FFFFL;    // << 12 still fits
+static const int32_t MAX_RATE_Q8 = 0x7FFFFL;    // * MAX_LEAD_Q4 still fits
+
+static uint16_t leadDistance(uint16_t a, uint16_t b) {
+  return a > b ? a - b : b - a;
+}
+
+/******************************************************************************
+ DESCRIPTION: Constructor, using initializer list. Starts with no lead, so
+  until a coast has been measured (or setLeads() is given a saved one) the
+  prediction is just the reading.
+*******************************************************************************/
+OvershootPredictor::OvershootPredictor()
+      :
+      _leads{0, 0},
+      _savedLeads{0, 0},
+      _last(0),
+      _rateQ8(0),
+      _switchValue(0),
+      _switchRateQ8(0),
+      _extreme(0),
+      _heaterOn(false),
+      _primed(false),
+      _coasting(false)
+      {}
+
+/******************************************************************************
+ DESCRIPTION: Feed one control period's filtered value in. heaterOn is the
+  heater's state going into this period's decision.
+
+ NOTES:
+  - Returns true when a lead has moved at least SAVE_STEP_Q4 from what was
+    last saved, i.e. when it is worth the EEPROM write; the caller saves
+    leads() and then calls markSaved().
+*******************************************************************************/
+bool OvershootPredictor::update(int32_t value, bool heaterOn) {
+  if (!_primed) {
+    _last   = value;
+    _primed = true;
+  }
+  _rateQ8  += ((value - _last) * 256 - _rateQ8) >> RATE_SHIFT;
+  _last     = value;
+  _heaterOn = heaterOn;
+
+  if (!_coasting) return false;
+
+  bool done;
+  if (_heaterOn) {
+    // Switched on: still falling until the heat comes through
+    if (value < _extreme) _extreme = value;
+    done = _rateQ8 > 0;
+  } else {
+    // Switched off: still rising until the stored heat is spent
+    if (value > _extreme) _extreme = value;
+    done = _rateQ8 < 0;
+  }
+  if (!done) return false;
+
+  finishCoast();
+  return leadDistance(_leads.offQ4, _savedLeads.offQ4) >= SAVE_STEP_Q4 ||
+         leadDistance(_leads.onQ4, _savedLeads.onQ4) >= SAVE_STEP_Q4;
+}
+
+/******************************************************************************
+ DESCRIPTION: The heater has just been switched; start measuring the coast
+  that follows, if it is moving fast enough to measure.
+*******************************************************************************/
+void OvershootPredictor::switched(bool heaterOn) {
+  _heaterOn = heaterOn;
+  _coasting = heaterOn ? _rateQ8 <= -MIN_RATE_Q8 : _rateQ8 >= MIN_RATE_Q8;
+  _switchValue  = _last;
+  _switchRateQ8 = _rateQ8;
+  _extreme      = _last;
+}
+
+/******************************************************************************
+ DESCRIPTION: The caller has saved leads(); only ask again once they have
+  moved on from these.
+*******************************************************************************/
+void OvershootPredictor::markSaved() {
+  _savedLeads = _leads;
+}
+
+/******************************************************************************
+ DESCRIPTION: The coast has turned round; learn its lead.
+*******************************************************************************/
+void OvershootPredictor::finishCoast() {
+  _coasting = false;
+  if (_heaterOn) {
+    learn(_leads.onQ4, _switchValue - _extreme, -_switchRateQ8);
+  } else {
+    learn(_leads.offQ4, _extreme - _switchValue, _switchRateQ8);
+  }
+}
+
+/******************************************************************************
+ DESCRIPTION: Move a lead towards coast / rate, the lead this coast shows.
+  The rate is at least MIN_RATE_Q8, from switched().
+*******************************************************************************/
+void OvershootPredictor::learn(uint16_t& leadQ4, int32_t coast, int32_t rateQ8) {
+  if (coast < 0) coast = 0;
+  if (coast > MAX_COAST) coast = MAX_COAST;
+
+  int32_t sample = (coast << 12) / rateQ8;   // Q8 rate, so Q4 periods
+  if (sample > MAX_LEAD_Q4) sample = MAX_LEAD_Q4;
+  leadQ4 = (uint16_t)(leadQ4 + ((sample - (int32_t)leadQ4) >> LEARN_SHIFT));
+}
+
+// ---- Setter/Getter Functions -----------------------------------------------
+
+/******************************************************************************
+ DESCRIPTION: Where the reading will end up if the heater is switched now:
+  the latest value plus the lead for the next switch times the rate.
+*******************************************************************************/
+int32_t OvershootPredictor::predicted() const {
+  int32_t lead = _heaterOn ? _leads.offQ4 : _leads.onQ4;
+  int32_t rate = constrain(_rateQ8, -MAX_RATE_Q8, MAX_RATE_Q8);
+  return _last + ((lead * rate + 2048) >> 12);
+}
+
+int32_t OvershootPredictor::rateQ8() const {
+  return _rateQ8;
+}
+
+/******************************************************************************
+ DESCRIPTION: Take leads learned before, e.g. from EEPROM. Anything past
+  MAX_LEAD_Q4 is taken as MAX_LEAD_Q4.
+*******************************************************************************/
+void OvershootPredictor::setLeads(const OvershootLeads& leads) {
+  _leads.offQ4 = leads.offQ4 > MAX_LEAD_Q4 ? MAX_LEAD_Q4 : leads.offQ4;
+  _leads.onQ4  = leads.onQ4 > MAX_LEAD_Q4 ? MAX_LEAD_Q4 : leads.onQ4;
+  _savedLeads  = _leads;
+}
+
+const OvershootLeads& OvershootPredictor::leads() const {
+  return _leads;
+}
@@ -0,0 +1,80 @@
+#ifndef OVERSHOOT_PREDICTOR_H
+#define OVERSHOOT_PREDICTOR_H
+
+#include <Arduino.h>
+
+/******************************************************************************
+ DESCRIPTION: This class is part of the Temperature Controller application.
+  It learns how far the box coasts past the point where the heater was
+  switched, and predicts where the temperature is heading so the hysteresis
+  control can switch that much early.
+
+ NOTES:
+  - The bulbs and the box walls hold heat, so after the heater goes off the
+    temperature keeps rising for a while, and after it comes back on it
+    keeps falling. How far it coasts goes with how fast it was moving, so
+    each direction is learned as a lead time: overshoot / rate at the
+    switch. The prediction is then value + lead * rate, using the lead for
+    whichever switch is next.
+  - The control turns the heater off on the prediction rather than the
+    reading (see predictiveWantOn() in the sketch), so the peaks land
+    nearer the top of the band rather than a whole coast past it.
+  - Values are whatever the caller filters in, as long as they rise with
+    temperature; the leads are in control periods (Q4), so they do not
+    depend on the units and one saved record suits every build.
+  - A coast is measured from the switch to where the smoothed rate changes
+    sign. A switch back before that throws the measurement away, as does a
+    rate at the switch below MIN_RATE_Q8, which would make the divide
+    meaningless. Each good measurement moves its lead 1/2^LEARN_SHIFT of
+    the way.
+  - The rate is smoothed heavily (1/2^RATE_SHIFT per period): the lead off
+    is tens of periods, so any noise left in the rate comes out that many
+    times over in the prediction and scatters the switch points, and the
+    widest coast sets the swing.
+  - update() is meant to be called once per control period, before the
+    decision, and switched() whenever the heater changes state.
+*******************************************************************************/
+
+struct OvershootLeads {
+  uint16_t offQ4;   // after heater-off, in control periods * 16
+  uint16_t onQ4;    // after heater-on
+};
+
+class OvershootPredictor {
+  public:
+    static const uint8_t  RATE_SHIFT   = 5;     // rate smoothing, 1/32 per period
+    static const uint8_t  LEARN_SHIFT  = 2;     // each coast moves its lead 1/4 of the way
+    static const int32_t  MIN_RATE_Q8  = 64;    // a quarter unit per period
+    static const uint16_t MAX_LEAD_Q4  = 240 * 16;
+    static const uint16_t SAVE_STEP_Q4 = 16;    // ask for a save once a lead moves a period
+
+    OvershootPredictor();
+
+    // ---- General Methods ---------------------------------------------------
+    bool update(int32_t value, bool heaterOn);
+    void switched(bool heaterOn);
+    void markSaved();
+
+    // ---- Setter/Getter Functions -------------------------------------------
+    int32_t predicted() const;
+    int32_t rateQ8() const;
+    void setLeads(const OvershootLeads& leads);
+    const OvershootLeads& leads() const;
+
+  private:
+    void finishCoast();
+    static void learn(uint16_t& leadQ4, int32_t coast, int32_t rateQ8);
+
+    OvershootLeads _leads;
+    OvershootLeads _savedLeads;
+    int32_t _last;               // value at the latest update()
+    int32_t _rateQ8;             // smoothed change per period, Q8
+    int32_t _switchValue;        // where the coast being measured started
+    int32_t _switchRateQ8;
+    int32_t _extreme;            // furthest it has coasted so far
+    bool _heaterOn;
+    bool _primed;                // seen a first value
+    bool _coasting;              // a measurement is under way
+};
+
+#endif // OVERSHOOT_PREDICTOR_H
@@ -0,0 +1,215 @@
+#include "BuildOptions.h"
+#include "PhaseAngleOutput.h"
+#include <avr/pgmspace.h>
+
+// Only build this (and claim the Timer1 and PORTA pin-change vectors) when
+// it is used.
+#if TC_OUTPUT_MODE == TC_OUTPUT_PHASE_ANGLE
+
+PhaseAngleOutput phaseSsr;
+
+// Timer1 runs free at clk/8: 1 us per tick at 8 MHz.
+constexpr uint16_t usToTicks(uint32_t us) {
+  return (uint16_t)(us * (F_CPU / 100000UL) / 80UL);
+}
+
+static const uint16_t GATE_PULSE_TICKS     = usToTicks(200);   // gate held high
+static const uint16_t MIN_DELAY_TICKS      = usToTicks(150);   // earliest fire after the edge
+static const uint16_t END_MARGIN_TICKS     = usToTicks(300);   // pulse must end this long before the next edge
+static const uint16_t MIN_HALF_CYCLE_TICKS = usToTicks(7000);  // ~71 Hz; anything sooner is noise
+static const uint16_t MAX_HALF_CYCLE_TICKS = usToTicks(11000); // ~45 Hz
+
+static const uint8_t DELAY_OFF = 0xFF;   // _delayFrac value for "never fire"
+
+/******************************************************************************
+ DESCRIPTION: Firing delay, in 1/256ths of a half-cycle, that gives a
+  resistive load i/16 of full power.
+
+ NOTES:
+  - Solves P(a) = 1 - a/pi + sin(2a)/(2 pi) for the firing angle a, then
+    scales a/pi to 0..255. setDuty() interpolates between entries.
+*******************************************************************************/
+static const uint8_t DELAY_FOR_POWER[17] PROGMEM = {
+  255, 199, 183, 171, 161, 152, 144, 135, 127, 120, 111, 103, 94, 84, 72, 56, 0 };
+
+/******************************************************************************
+ DESCRIPTION: Constructor, using initializer list. Nothing touches the
+  hardware until begin().
+*******************************************************************************/
+PhaseAngleOutput::PhaseAngleOutput()
+      :
+      _gatePort(0),
+      _zcPin(0),
+      _gateMask(0),
+      _zcMask(0),
+      _delayFrac(DELAY_OFF),
+      _halfCycleTicks(usToTicks(10000)),
+      _mainsOk(false),
+      _duty(0)
+      {}
+
+/******************************************************************************
+ DESCRIPTION: Take over the gate pin, the zero-cross pin and Timer1.
+
+ NOTES:
+  - gatePin must already be an OUTPUT (and low). zeroCrossPin is made an
+    INPUT here; it must be a PORTA pin (PA0..PA7), whose bit number is also
+    its PCINT number.
+  - The output starts off (duty 0), and nothing fires until two zero
+    crossings have given us a half-cycle measurement.
+*******************************************************************************/
+void PhaseAngleOutput::begin(uint8_t gatePin, uint8_t zeroCrossPin) {
+  _gatePort = portOutputRegister(digitalPinToPort(gatePin));
+  _gateMask = digitalPinToBitMask(gatePin);
+  _zcPin    = portInputRegister(digitalPinToPort(zeroCrossPin));
+  _zcMask   = digitalPinToBitMask(zeroCrossPin);
+  pinMode(zeroCrossPin, INPUT);
+
+  TCCR1A = 0;
+  TCCR1B = _BV(CS11);        // normal mode, clk/8
+  TCNT1  = 0;
+  TIFR1  = _BV(OCF1A) | _BV(OCF1B) | _BV(TOV1);
+  TIMSK1 = (TIMSK1 & ~(_BV(OCIE1A) | _BV(OCIE1B))) | _BV(TOIE1);
+
+  PCMSK0 |= _zcMask;
+  GIMSK  |= _BV(PCIE0);
+}
+
+/******************************************************************************
+ DESCRIPTION: Set the heater power, 0..255 of full power. Takes effect from
+  the next zero crossing.
+*******************************************************************************/
+void PhaseAngleOutput::setDuty(uint8_t duty) {
+  _duty = duty;
+  if (duty == 0) {
+    _delayFrac = DELAY_OFF;
+    return;
+  }
+
+  uint8_t i    = duty >> 4;
+  uint8_t frac = duty & 0x0F;
+  uint8_t a    = pgm_read_byte(&DELAY_FOR_POWER[i]);
+  uint8_t b    = pgm_read_byte(&DELAY_FOR_POWER[i + 1]);
+  _delayFrac = a - (uint8_t)(((uint16_t)(a - b) * frac + 8) >> 4);   // one byte: no need to guard it
+}
+
+/******************************************************************************
+ DESCRIPTION: Zero-cross handler. Restarts Timer1, keeps the half-cycle
+  measurement up to date and arms compare A for this half-cycle's firing.
+*******************************************************************************/
+void PhaseAngleOutput::onZeroCross() {
+  if (!(*_zcPin & _zcMask)) return;   // falling edge: end of the detector pulse, ignore
+
+  uint16_t elapsed = TCNT1;
+  if (_mainsOk && elapsed < MIN_HALF_CYCLE_TICKS) return;   // noise, not a crossing
+
+  TCNT1 = 0;
+  *_gatePort &= (uint8_t)~_gateMask;  // a late pulse never runs into the next half-cycle
+  TIMSK1 &= ~(_BV(OCIE1A) | _BV(OCIE1B));
+
+  if (elapsed >= MIN_HALF_CYCLE_TICKS && elapsed <= MAX_HALF_CYCLE_TICKS) {
+    uint16_t halfCycle = elapsed;
+    if (_mainsOk) {
+      halfCycle = _halfCycleTicks;
+      halfCycle += ((int16_t)(elapsed - halfCycle)) >> 2;   // light smoothing
+    }
+    _halfCycleTicks = halfCycle;
+    _mainsOk = true;
+  } else {
+    _mainsOk = false;   // first edge after a gap: just a reference point
+    return;
+  }
+
+  uint8_t delayFrac = _delayFrac;
+  if (delayFrac == DELAY_OFF) return;
+
+  uint16_t delay = (uint16_t)(((uint32_t)delayFrac * _halfCycleTicks) >> 8);
+  if (delay < MIN_DELAY_TICKS) delay = MIN_DELAY_TICKS;
+  if (delay + GATE_PULSE_TICKS + END_MARGIN_TICKS >= _halfCycleTicks) return;
+
+  OCR1A  = delay;
+  TIFR1  = _BV(OCF1A);
+  TIMSK1 |= _BV(OCIE1A);
+}
+
+/******************************************************************************
+ DESCRIPTION: Compare A handler: fire the gate and arm compare B to end the
+  pulse.
+*******************************************************************************/
+void PhaseAngleOutput::onFire() {
+  *_gatePort |= _gateMask;
+  OCR1B  = OCR1A + GATE_PULSE_TICKS;
+  TIFR1  = _BV(OCF1B);
+  TIMSK1 = (TIMSK1 & ~_BV(OCIE1A)) | _BV(OCIE1B);
+}
+
+/******************************************************************************
+ DESCRIPTION: Compare B handler: end of the gate pulse. The triac stays on
+  by itself until the load current next passes through zero.
+*******************************************************************************/
+void PhaseAngleOutput::onGateEnd() {
+  *_gatePort &= (uint8_t)~_gateMask;
+  TIMSK1 &= ~_BV(OCIE1B);
+}
+
+/******************************************************************************
+ DESCRIPTION: Timer1 overflow handler: no zero crossing for a whole timer
+  period. Stop firing until they come back.
+*******************************************************************************/
+void PhaseAngleOutput::onMainsLost() {
+  *_gatePort &= (uint8_t)~_gateMask;
+  TIMSK1 &= ~(_BV(OCIE1A) | _BV(OCIE1B));
+  _mainsOk = false;
+}
+
+/******************************************************************************
+ DESCRIPTION: Duty 0, and no firing left pending in this half-cycle (e.g. the
+  sensor has failed). A triac already fired stays on until the next zero
+  crossing, at most one half-cycle; nothing can cut that short.
+*******************************************************************************/
+void PhaseAngleOutput::shutOff() {
+  setDuty(0);
+
+  uint8_t sreg = SREG;
+  cli();
+  *_gatePort &= (uint8_t)~_gateMask;
+  TIMSK1 &= ~(_BV(OCIE1A) | _BV(OCIE1B));
+  SREG = sreg;
+}
+
+/******************************************************************************
+ DESCRIPTION: Getter methods
+*******************************************************************************/
+uint8_t PhaseAngleOutput::duty() const {
+  return _duty;
+}
+
+bool PhaseAngleOutput::hasMains() const {
+  return _mainsOk;
+}
+
+uint16_t PhaseAngleOutput::halfCycleUs() const {
+  uint8_t sreg = SREG;    // 16-bit value shared with the ISR
+  cli();
+  uint16_t ticks = _halfCycleTicks;
+  SREG = sreg;
+  return (uint16_t)((uint32_t)ticks * 80UL / (F_CPU / 100000UL));
+}
+
+ISR(PCINT0_vect) {
+  phaseSsr.onZeroCross();
+}
+
+ISR(TIM1_COMPA_vect) {
+  phaseSsr.onFire();
+}
+
+ISR(TIM1_COMPB_vect) {
+  phaseSsr.onGateEnd();
+}
+
+ISR(TIM1_OVF_vect) {
+  phaseSsr.onMainsLost();
+}
+
+#endif // TC_OUTPUT_MODE == TC_OUTPUT_PHASE_ANGLE
@@ -0,0 +1,69 @@
+#ifndef PHASE_ANGLE_OUTPUT_H
+#define PHASE_ANGLE_OUTPUT_H
+
+#include <Arduino.h>
+
+/******************************************************************************
+ DESCRIPTION: This class is part of the Temperature Controller application.
+  It drives a triac (through an opto-triac such as a MOC3021) or a
+  random-fire SSR by phase angle: every mains half-cycle it waits a computed
+  delay after the zero crossing and then fires the gate, so the heater gets
+  continuous 0..100% power instead of whole on/off windows.
+
+ NOTES:
+  - Needs a zero-cross detector (e.g. an H11AA1 with a pull-up) whose output
+    goes HIGH at each zero crossing. It must be on a PORTA pin, since it
+    uses the PORTA pin-change interrupt (PCINT0_vect).
+  - Everything after the zero crossing is done in hardware and ISRs: the
+    pin-change ISR restarts Timer1 and sets compare A to the firing delay,
+    compare A raises the gate and sets compare B for the end of the gate
+    pulse, compare B drops it. Jitter is a few microseconds of interrupt
+    latency, whatever loop() is doing, as long as nothing stops Timer1:
+    the CPU may only idle-sleep, never noise-reduction or power-down
+    sleep (BuildOptions.h refuses those builds).
+  - Timer1 also measures the half-cycle, so 50 Hz and 60 Hz mains both
+    work without configuration. If the zero crossings stop for one Timer1
+    overflow (~65 ms at 8 MHz) the gate is simply never fired again until
+    they come back, which is the safe way to fail.
+  - Duty is 0..255 of full POWER, not of phase angle. For a resistive load
+    (our bulbs) power is far from linear in the firing delay, so a small
+    PROGMEM table maps one to the other.
+  - Delays are measured from the detector's rising edge, which comes a
+    little before the true zero; near full power that only costs a sliver
+    of the half-cycle.
+  - Timer1 is not available for anything else while this is in use. There
+    is exactly one instance: phaseSsr.
+*******************************************************************************/
+
+class PhaseAngleOutput {
+  public:
+    PhaseAngleOutput();
+
+    // ---- General Methods ---------------------------------------------------
+    void begin(uint8_t gatePin, uint8_t zeroCrossPin);
+    void onZeroCross();         // only called from the pin-change ISR
+    void onFire();              // only called from the Timer1 compare A ISR
+    void onGateEnd();           // only called from the Timer1 compare B ISR
+    void onMainsLost();         // only called from the Timer1 overflow ISR
+    void shutOff();
+
+    // ---- Setter/Getter Functions -------------------------------------------
+    void setDuty(uint8_t duty);
+    uint8_t duty() const;
+    bool hasMains() const;
+    uint16_t halfCycleUs() const;
+
+  private:
+    volatile uint8_t* _gatePort;
+    volatile uint8_t* _zcPin;       // input register of the zero-cross pin
+    uint8_t _gateMask;
+    uint8_t _zcMask;
+    volatile uint8_t _delayFrac;    // firing delay, 1/256ths of a half-cycle
+    volatile uint16_t _halfCycleTicks;
+    volatile bool _mainsOk;
+    uint8_t _duty;
+};
+
+extern PhaseAngleOutput phaseSsr;
+
+#endif // PHASE_ANGLE_OUTPUT_H
@@ -0,0 +1,98 @@
+#include "PidController.h"
+
+static const int32_t OUTPUT_MAX_Q8  = (int32_t)PidController::OUTPUT_MAX << 8;
+static const int32_t OUTPUT_MAX_Q16 = (int32_t)PidController::OUTPUT_MAX << 16;
+
+// Clamp an error or a rise to the span the gains are multiplied over.
+static int32_t clampToSpan(int32_t v) {
+  if (v >  PidController::INPUT_SPAN_CF) return  PidController::INPUT_SPAN_CF;
+  if (v < -PidController::INPUT_SPAN_CF) return -PidController::INPUT_SPAN_CF;
+  return v;
+}
+
+/******************************************************************************
+ DESCRIPTION: Constructor, using initializer list.
+*******************************************************************************/
+PidController::PidController(const PidGains& gains)
+      :
+      _gains(gains),
+      _iTermQ16(0),
+      _lastTemp(0),
+      _primed(false),
+      _output(0)
+      {}
+
+/******************************************************************************
+ DESCRIPTION: Run one control step and return the new duty, 0..255.
+
+ NOTES:
+  - Call it once per control period; the gains assume that period.
+  - The first call after construction or reset() has no previous reading,
+    so it skips the D term rather than treating the jump from 0 as a rise.
+  - Everything is worked in Q8 duty and rounded once at the end. With the
+    error and rise clamped to INPUT_SPAN_CF, each product is under
+    65535 * 8191 < 2^29, the integral under that plus 255 << 16, and the
+    output sum under 2 * 2^29 + (255 << 8): all well inside int32_t.
+*******************************************************************************/
+uint8_t PidController::update(TempCF setPoint, TempCF temperature) {
+  int32_t error = clampToSpan((int32_t)setPoint - temperature);
+
+  if (!_primed) {
+    _lastTemp = temperature;
+    _primed   = true;
+  }
+  int32_t rise = clampToSpan((int32_t)temperature - _lastTemp);
+  _lastTemp = temperature;
+
+  // Integral, clamped to what the output can actually use
+  int32_t iStep = (int32_t)_gains.kiQ16 * error;
+  int32_t iTerm = _iTermQ16 + iStep;
+  if (iTerm < 0) iTerm = 0;
+  if (iTerm > OUTPUT_MAX_Q16) iTerm = OUTPUT_MAX_Q16;
+
+  int32_t outQ8 = (int32_t)_gains.kpQ8 * error
+                - (int32_t)_gains.kdQ8 * rise
+                + (iTerm >> 8);
+
+  // Saturated: keep the output in range, and don't let the integral carry
+  // on winding up in the direction that got us here.
+  if (outQ8 > OUTPUT_MAX_Q8) {
+    outQ8 = OUTPUT_MAX_Q8;
+    if (iStep > 0) iTerm = _iTermQ16;
+  } else if (outQ8 < 0) {
+    outQ8 = 0;
+    if (iStep < 0) iTerm = _iTermQ16;
+  }
+  _iTermQ16 = iTerm;
+
+  _output = (uint8_t)((outQ8 + 128) >> 8);   // round to nearest
+  return _output;
+}
+
+/******************************************************************************
+ DESCRIPTION: Forget the integral and the previous reading, e.g. after the
+  heater has been forced off for a while.
+*******************************************************************************/
+void PidController::reset() {
+  _iTermQ16 = 0;
+  _primed   = false;
+  _output   = 0;
+}
+
+/******************************************************************************
+ DESCRIPTION: Setter methods
+*******************************************************************************/
+void PidController::setGains(const PidGains& gains) {
+  _gains = gains;
+}
+
+/******************************************************************************
+ DESCRIPTION: Getter methods
+*******************************************************************************/
+const PidGains& PidController::gains() const {
+  return _gains;
+}
+
+uint8_t PidController::output() const {
+  return _output;
+}
@@ -0,0 +1,71 @@
+#ifndef PID_CONTROLLER_H
+#define PID_CONTROLLER_H
+
+#include <Arduino.h>
+#include "FixedTemp.h"
+
+/******************************************************************************
+ DESCRIPTION: PID gains in the fixed-point units PidController works in.
+
+ NOTES:
+  - The output is an SSR duty, 0..255, and the input is in TempCF
+    (hundredths of a °F). One update happens every control period, so the
+    integral and derivative gains already have that period folded in.
+  - kpQ8:  duty per hundredth of a °F of error, Q8.
+  - kiQ16: duty added to the integral per hundredth of a °F of error, per
+    update, Q16. (It is that small.)
+  - kdQ8:  duty taken off per hundredth of a °F the temperature rose since
+    the last update, Q8.
+  - Build them from engineering units with the compiler; see the PID
+    Constants section of the sketch.
+*******************************************************************************/
+struct PidGains {
+  uint16_t kpQ8;
+  uint16_t kiQ16;
+  uint16_t kdQ8;
+};
+
+/******************************************************************************
+ DESCRIPTION: This class is part of the Temperature Controller application.
+  It is an integer-only PID controller whose output is the duty for a
+  proportional heater output (e.g. TimeProportionalOutput).
+
+ NOTES:
+  - Derivative on measurement: the D term works on the change in the
+    temperature, not in the error, so turning the pot does not kick the
+    output.
+  - Anti-windup, two ways: the integral is clamped to the output range, and
+    it stops growing while the output is saturated in the direction it is
+    pushing.
+  - The error and the rise are clamped to +/-INPUT_SPAN_CF (81.91 °F)
+    before the gains see them. That is what keeps the arithmetic inside
+    int32_t for any 16-bit gains; past it, any kpQ8 of 8 or more has the
+    output saturated anyway.
+  - No floats, and 14 bytes of state.
+*******************************************************************************/
+
+class PidController {
+  public:
+    static const uint8_t OUTPUT_MAX = 255;
+    static const int16_t INPUT_SPAN_CF = 8191;
+
+    PidController(const PidGains& gains);
+
+    // ---- General Methods ---------------------------------------------------
+    uint8_t update(TempCF setPoint, TempCF temperature);
+    void reset();
+
+    // ---- Setter/Getter Functions -------------------------------------------
+    void setGains(const PidGains& gains);
+    const PidGains& gains() const;
+    uint8_t output() const;
+
+  private:
+    PidGains _gains;
+    int32_t _iTermQ16;      // integral share of the output, Q16 duty
+    TempCF _lastTemp;       // for the derivative
+    bool _primed;           // false until _lastTemp holds a real reading
+    uint8_t _output;
+};
+
+#endif // PID_CONTROLLER_H
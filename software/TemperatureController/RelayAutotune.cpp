@@ -0,0 +1,138 @@
+#include "RelayAutotune.h"
+
+// Smallest half peak-to-peak we trust, in hundredths of a °F. Below this the
+// LM19's resolution is most of the reading.
+static const uint16_t MIN_AMPLITUDE_CF = 10;
+
+// Ku = 4d / (pi a) with the relay swinging the duty 0..255, so d = 127.5.
+// The Tyreus-Luyben factors are folded in here so finish() is left with
+// one integer divide per gain. The compiler works all of these out.
+constexpr float    KU_NUM     = 4.0f * 127.5f / 3.14159265f;   // Ku * a, duty
+static const uint32_t KP_Q8_NUM  = (uint32_t)(KU_NUM / 2.2f * 256.0f + 0.5f);
+static const uint32_t KI_Q16_NUM = (uint32_t)(KU_NUM / (2.2f * 2.2f) * 65536.0f + 0.5f);
+static const uint32_t KD_Q8_NUM  = (uint32_t)(KU_NUM / (2.2f * 6.3f) * 256.0f + 0.5f);
+
+static uint16_t clampGain(uint32_t gain) {
+  return gain > 0xFFFF ? 0xFFFF : (uint16_t)gain;
+}
+
+/******************************************************************************
+ DESCRIPTION: Constructor, using initializer list. controlPeriodMs is how
+  often update() will be called.
+*******************************************************************************/
+RelayAutotune::RelayAutotune(uint16_t controlPeriodMs)
+      :
+      _controlPeriodMs(controlPeriodMs),
+      _state(Idle),
+      _wasOn(false),
+      _cycles(0),
+      _setPoint(0),
+      _minTemp(0),
+      _maxTemp(0),
+      _cycleStartMs(0),
+      _periodSumMs(0),
+      _swingSumCF(0),
+      _gains{0, 0, 0}
+      {}
+
+/******************************************************************************
+ DESCRIPTION: Begin a tuning run. The set-point is picked up from the first
+  update().
+*******************************************************************************/
+void RelayAutotune::start() {
+  _state = Running;
+  restart(0);
+}
+
+/******************************************************************************
+ DESCRIPTION: Feed one control period's worth of readings in. heaterOn is
+  what the hysteresis control decided this period.
+
+ NOTES:
+  - Returns true exactly once: on the update that finishes a successful
+    run. gains() is good from then on.
+*******************************************************************************/
+bool RelayAutotune::update(unsigned long now, TempCF setPoint, TempCF temperature, bool heaterOn) {
+  if (_state != Running) return false;
+
+  if (setPoint != _setPoint) {
+    restart(setPoint);
+  }
+
+  if (temperature < _minTemp) _minTemp = temperature;
+  if (temperature > _maxTemp) _maxTemp = temperature;
+
+  bool turnedOn = heaterOn && !_wasOn;
+  _wasOn = heaterOn;
+
+  if (turnedOn) {
+    // One turn-on ends cycle _cycles and starts the next
+    if (_cycles > DISCARD_CYCLES) {
+      _periodSumMs += now - _cycleStartMs;
+      _swingSumCF  += (uint16_t)(_maxTemp - _minTemp);
+    }
+    if (_cycles == DISCARD_CYCLES + MEASURE_CYCLES) {
+      finish();
+      return _state == Done;
+    }
+    _cycles++;
+    _cycleStartMs = now;
+    _minTemp = temperature;
+    _maxTemp = temperature;
+  } else if (_cycles > 0 && now - _cycleStartMs > MAX_CYCLE_MS) {
+    _state = Failed;   // not oscillating; heater too weak or box too leaky
+  }
+  return false;
+}
+
+/******************************************************************************
+ DESCRIPTION: Throw away everything measured so far and wait for the next
+  turn-on to start cycle 1 again.
+*******************************************************************************/
+void RelayAutotune::restart(TempCF setPoint) {
+  _setPoint    = setPoint;
+  _wasOn       = false;
+  _cycles      = 0;
+  _periodSumMs = 0;
+  _swingSumCF  = 0;
+}
+
+/******************************************************************************
+ DESCRIPTION: Turn the averaged period and amplitude into PID gains.
+
+ NOTES:
+  - The order of the multiplies and divides keeps every step inside 32
+    bits for amplitudes down to MIN_AMPLITUDE_CF and control periods up to
+    10 s.
+*******************************************************************************/
+void RelayAutotune::finish() {
+  uint32_t amplitudeCF = _swingSumCF / (2 * MEASURE_CYCLES);
+  uint32_t periodMs    = _periodSumMs / MEASURE_CYCLES;
+
+  if (amplitudeCF < MIN_AMPLITUDE_CF || periodMs < _controlPeriodMs) {
+    _state = Failed;
+    return;
+  }
+
+  _gains.kpQ8  = clampGain(KP_Q8_NUM / amplitudeCF);
+  _gains.kiQ16 = clampGain((KI_Q16_NUM / amplitudeCF) * _controlPeriodMs / periodMs);
+  _gains.kdQ8  = clampGain(KD_Q8_NUM * (periodMs / _controlPeriodMs) / amplitudeCF);
+  if (_gains.kiQ16 == 0) _gains.kiQ16 = 1;   // keep some integral action
+
+  _state = Done;
+}
+
+/******************************************************************************
+ DESCRIPTION: Getter methods
+*******************************************************************************/
+bool RelayAutotune::isRunning() const {
+  return _state == Running;
+}
+
+bool RelayAutotune::hasFailed() const {
+  return _state == Failed;
+}
+
+const PidGains& RelayAutotune::gains() const {
+  return _gains;
+}
@@ -0,0 +1,68 @@
+#ifndef RELAY_AUTOTUNE_H
+#define RELAY_AUTOTUNE_H
+
+#include <Arduino.h>
+#include "FixedTemp.h"
+#include "PidController.h"
+
+/******************************************************************************
+ DESCRIPTION: This class is part of the Temperature Controller application.
+  It works out PID gains for the box it is running in, by the relay-feedback
+  (Astrom-Hagglund) method.
+
+ NOTES:
+  - The sketch keeps running the plain hysteresis on/off control at full
+    power while this watches. That makes the temperature settle into a
+    steady oscillation around the set-point, and its period Pu and
+    amplitude a give the ultimate gain Ku = 4d / (pi a), where d is half the
+    output swing.
+  - A cycle runs from one heater turn-on to the next. The first one is
+    mostly the warm-up from room temperature and is thrown away; the next
+    MEASURE_CYCLES are averaged.
+  - Gains use the Tyreus-Luyben rules (Kp = Ku/2.2, Ti = 2.2 Pu,
+    Td = Pu/6.3). They are slower than Ziegler-Nichols but overshoot far
+    less, which suits a heated box.
+  - A set-point change starts the measurement over. A cycle longer than
+    MAX_CYCLE_MS, or an oscillation too small to measure, fails the run;
+    the caller's gains are then left as they were.
+  - update() is meant to be called once per control period with the same
+    temperature the PID would see; the gains assume that period.
+*******************************************************************************/
+
+class RelayAutotune {
+  public:
+    static const uint8_t DISCARD_CYCLES = 1;
+    static const uint8_t MEASURE_CYCLES = 3;
+    static const unsigned long MAX_CYCLE_MS = 3600000UL;   // 1 hour
+
+    RelayAutotune(uint16_t controlPeriodMs);
+
+    // ---- General Methods ---------------------------------------------------
+    void start();
+    bool update(unsigned long now, TempCF setPoint, TempCF temperature, bool heaterOn);
+
+    // ---- Setter/Getter Functions -------------------------------------------
+    bool isRunning() const;
+    bool hasFailed() const;
+    const PidGains& gains() const;
+
+  private:
+    enum State : uint8_t { Idle, Running, Done, Failed };
+
+    void restart(TempCF setPoint);
+    void finish();
+
+    uint16_t _controlPeriodMs;
+    State _state;
+    bool _wasOn;
+    uint8_t _cycles;             // turn-ons seen since the (re)start
+    TempCF _setPoint;
+    TempCF _minTemp;             // this cycle
+    TempCF _maxTemp;
+    unsigned long _cycleStartMs;
+    uint32_t _periodSumMs;       // measured cycles only
+    uint32_t _swingSumCF;        // sum of peak-to-peak, measured cycles
+    PidGains _gains;
+};
+
+#endif // RELAY_AUTOTUNE_H
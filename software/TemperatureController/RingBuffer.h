@@ -0,0 +1,65 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <Arduino.h>
+
+/******************************************************************************
+ DESCRIPTION: Tiny lock-free ring buffer for handing data from ONE interrupt
+  service routine (the producer) to ONE piece of main-loop code (the
+  consumer).
+
+ NOTES:
+  - No locking is needed because each index is only ever written by one side:
+    push() moves _head, pop() moves _tail, and on the AVR a uint8_t
+    read/write can't be torn by an interrupt.
+  - Size must be a power of two (2..128) so wrapping is a single AND. One
+    slot is kept empty to tell "full" from "empty", so it holds Size - 1
+    items.
+  - It works just as well the other way round, with main-loop code as the
+    producer and an ISR draining it (see TelemetryTx).
+  - This is a template, so unlike the other modules it lives entirely in
+    the header.
+*******************************************************************************/
+
+template <typename T, uint8_t Size>
+class RingBuffer {
+    static_assert(Size >= 2 && Size <= 128 && (Size & (Size - 1)) == 0,
+                  "RingBuffer Size must be a power of two, 2..128");
+
+  public:
+    RingBuffer() : _head(0), _tail(0) {}
+
+    // ---- Producer side (ISR) -----------------------------------------------
+    // Returns false, and drops the item, if the buffer is full.
+    bool push(const T& item) {
+      uint8_t next = (_head + 1) & (Size - 1);
+      if (next == _tail) return false;
+      _items[_head] = item;
+      __asm__ __volatile__("" ::: "memory");  // item is stored before _head moves
+      _head = next;
+      return true;
+    }
+
+    // ---- Consumer side (main loop) -----------------------------------------
+    // Returns false if there was nothing to take.
+    bool pop(T& item) {
+      uint8_t tail = _tail;
+      if (tail == _head) return false;
+      item = _items[tail];
+      __asm__ __volatile__("" ::: "memory");  // item is read before _tail moves
+      _tail = (tail + 1) & (Size - 1);
+      return true;
+    }
+
+    bool isEmpty() const { return _tail == _head; }
+
+    // Free slots, as seen from the producer side.
+    uint8_t space() const { return (uint8_t)(_tail - _head - 1) & (Size - 1); }
+
+  private:
+    T _items[Size];
+    volatile uint8_t _head;
+    volatile uint8_t _tail;
+};
+
+#endif // RING_BUFFER_H
@@ -0,0 +1,97 @@
+#include "SensorFault.h"
+
+/******************************************************************************
+ DESCRIPTION: Constructor, using initializer list. minPos and maxPos are the
+  LM19 clamp (they and anything beyond are a rail), maxStep the most a
+  reading may move from one sample to the next.
+*******************************************************************************/
+SensorFault::SensorFault(uint16_t minPos, uint16_t maxPos, uint16_t maxStep,
+                         uint16_t stuckSamples, uint8_t clearSamples)
+      :
+      _minPos(minPos),
+      _maxPos(maxPos),
+      _maxStep(maxStep),
+      _stuckSamples(stuckSamples),
+      _clearSamples(clearSamples),
+      _lastPos(0),
+      _sameCount(0),
+      _goodCount(0),
+      _fault(None)
+      {}
+
+/******************************************************************************
+ DESCRIPTION: Start over from the first reading after power-on. Returns
+  false if it is already on a rail.
+
+ NOTES:
+  - There is nothing to take a rate from yet, so only the rails are
+    checked. A fault found here needs clearSamples good readings like any
+    other.
+*******************************************************************************/
+bool SensorFault::begin(uint16_t pos) {
+  _lastPos   = pos;
+  _sameCount = 0;
+  _goodCount = 0;
+  _fault     = (pos <= _minPos || pos >= _maxPos) ? Rail : None;
+  return _fault == None;
+}
+
+/******************************************************************************
+ DESCRIPTION: Check one new reading. Returns true when it can be used, false
+  while there is a fault (this reading's, or one not yet cleared).
+
+ NOTES:
+  - heatingFull is whether the heater is on at full power, which is when a
+    reading that never moves is taken for a stuck one.
+*******************************************************************************/
+bool SensorFault::check(uint16_t pos, bool heatingFull) {
+  Fault fault = classify(pos, heatingFull);
+  _lastPos = pos;
+
+  if (fault != None) {
+    _fault     = fault;
+    _goodCount = 0;
+    return false;
+  }
+  if (_fault == None) return true;
+
+  if (++_goodCount < _clearSamples) return false;
+  _fault = None;
+  return true;
+}
+
+/******************************************************************************
+ DESCRIPTION: What, if anything, is wrong with this reading.
+
+ NOTES:
+  - A stuck fault only clears once the reading moves, whatever the heater
+    is doing; the heater being off because of it proves nothing.
+*******************************************************************************/
+SensorFault::Fault SensorFault::classify(uint16_t pos, bool heatingFull) {
+  if (pos <= _minPos || pos >= _maxPos) return Rail;
+
+  uint16_t step = pos > _lastPos ? pos - _lastPos : _lastPos - pos;
+  if (step > _maxStep) return Rate;
+
+  if (step != 0) {
+    _sameCount = 0;
+    return None;
+  }
+  if (_fault == Stuck) return Stuck;
+  if (!heatingFull) {
+    _sameCount = 0;
+    return None;
+  }
+  if (_sameCount < _stuckSamples) _sameCount++;
+  return _sameCount >= _stuckSamples ? Stuck : None;
+}
+
+// ---- Setter/Getter Functions -----------------------------------------------
+
+bool SensorFault::faulted() const {
+  return _fault != None;
+}
+
+SensorFault::Fault SensorFault::fault() const {
+  return _fault;
+}
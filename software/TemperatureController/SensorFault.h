@@ -0,0 +1,62 @@
+#ifndef SENSOR_FAULT_H
+#define SENSOR_FAULT_H
+
+#include <Arduino.h>
+
+/******************************************************************************
+ DESCRIPTION: This class is part of the Temperature Controller application.
+  It watches the raw LM19 readings, before they are clamped or filtered, for
+  the signs of a sensor that has failed rather than a box that has changed
+  temperature, so the heater can be shut off on the sample that shows it.
+
+ NOTES:
+  - Readings are LM19 table positions (see LM19.h); the limits are handed
+    in, in the same units, by the sketch.
+  - Three kinds of fault:
+      * Rail: the reading is at or past the 0.2 V .. 2.8 V the LM19 can put
+        out (i.e. what the driver would clamp). An open sensor, or a short
+        to either supply rail, lands here, usually as "very cold".
+      * Rate: the reading moved further in one sample than the box can, a
+        loose connection or a sensor floating in the noise.
+      * Stuck: the exact same reading for stuckSamples samples in a row
+        while the heater is on full. The box must warm under full power,
+        so a reading that never moves means the reading isn't the box.
+        Noise sleep makes readings quiet enough to repeat, so it only
+        counts while heating; and it takes that many samples, not one.
+  - Rail and rate faults are caught on the one sample. check() returns
+    false from then on until clearSamples good readings in a row have been
+    seen, so a single glitch costs a few seconds of heat rather than the
+    whole run and a broken sensor keeps the heater off for good.
+  - begin() sees the first reading after power-on, so a sensor that is
+    already broken is caught before control ever runs.
+  - RAM: 15 bytes, the limits included.
+*******************************************************************************/
+
+class SensorFault {
+  public:
+    enum Fault : uint8_t { None, Rail, Rate, Stuck };
+
+    SensorFault(uint16_t minPos, uint16_t maxPos, uint16_t maxStep,
+                uint16_t stuckSamples, uint8_t clearSamples);
+
+    // ---- General Methods ---------------------------------------------------
+    bool begin(uint16_t pos);
+    bool check(uint16_t pos, bool heatingFull);
+
+    // ---- Setter/Getter Functions -------------------------------------------
+    bool faulted() const;
+    Fault fault() const;
+
+  private:
+    Fault classify(uint16_t pos, bool heatingFull);
+
+    uint16_t _minPos, _maxPos, _maxStep;
+    uint16_t _stuckSamples;
+    uint8_t _clearSamples;
+    uint16_t _lastPos;
+    uint16_t _sameCount;        // identical readings in a row while heating
+    uint8_t _goodCount;         // good readings in a row since the fault
+    Fault _fault;
+};
+
+#endif // SENSOR_FAULT_H
@@ -0,0 +1,54 @@
+#include "SetpointKnob.h"
+
+/******************************************************************************
+ DESCRIPTION: Constructor, using initializer list. map turns a pot reading
+  (0..1023) into hundredths of a °F.
+*******************************************************************************/
+SetpointKnob::SetpointKnob(PotMap map, TempCF stepCF, TempCF hysteresisCF)
+      :
+      _map(map),
+      _stepCF(stepCF),
+      _holdCF(stepCF / 2 + hysteresisCF),
+      _setPointCF(0),
+      _lastRaw(0xFFFF)
+      {}
+
+/******************************************************************************
+ DESCRIPTION: Take a first reading as the set-point straight away, with no
+  hysteresis to get past.
+*******************************************************************************/
+void SetpointKnob::begin(uint16_t potRaw) {
+  _lastRaw    = potRaw;
+  _setPointCF = quantize(_map(potRaw));
+}
+
+/******************************************************************************
+ DESCRIPTION: Feed in the latest pot reading. Returns true when it moved the
+  set-point.
+*******************************************************************************/
+bool SetpointKnob::update(uint16_t potRaw) {
+  if (potRaw == _lastRaw) return false;   // knob left alone
+  _lastRaw = potRaw;
+
+  TempCF mapped = _map(potRaw);
+  if (mapped > _setPointCF - _holdCF && mapped < _setPointCF + _holdCF) {
+    return false;                         // still within this step
+  }
+
+  _setPointCF = quantize(mapped);
+  return true;
+}
+
+/******************************************************************************
+ DESCRIPTION: The nearest multiple of the step. Set-points are never
+  negative, so the divide rounds the way it should.
+*******************************************************************************/
+TempCF SetpointKnob::quantize(TempCF tempCF) const {
+  return (TempCF)((tempCF + _stepCF / 2) / _stepCF * _stepCF);
+}
+
+// ---- Setter/Getter Functions -----------------------------------------------
+
+TempCF SetpointKnob::setPointCF() const {
+  return _setPointCF;
+}
@@ -0,0 +1,51 @@
+#ifndef SETPOINT_KNOB_H
+#define SETPOINT_KNOB_H
+
+#include <Arduino.h>
+#include "FixedTemp.h"
+
+/******************************************************************************
+ DESCRIPTION: This class is part of the Temperature Controller application.
+  It turns pot readings into the set-point: mapped to °F, quantized to
+  whole steps, and held against ADC jitter, so the set-point only changes
+  when the knob has really been turned.
+
+ NOTES:
+  - The mapping from pot to temperature is the sketch's; it is handed in as
+    a function. It is only run when the reading differs from the last one,
+    so a knob left alone costs one compare per update().
+  - The set-point is a multiple of stepCF. A reading has to land more than
+    hysteresisCF past the edge of the current step before the set-point
+    moves to the step it is nearest to; a pot sitting on an edge, flickering
+    by a count or two, then stays on one side of it.
+  - That hysteresis is also the debounce. The readings handed in are
+    already averaged (a block of them with TC_ADC_INTERRUPT), so there is
+    no separate settling count.
+  - update() returns true only when the set-point changed: the cue to rebuild
+    anything worked out from it (band thresholds, LED edges).
+*******************************************************************************/
+
+class SetpointKnob {
+  public:
+    typedef TempCF (*PotMap)(uint16_t potRaw);
+
+    SetpointKnob(PotMap map, TempCF stepCF, TempCF hysteresisCF);
+
+    // ---- General Methods ---------------------------------------------------
+    void begin(uint16_t potRaw);
+    bool update(uint16_t potRaw);
+
+    // ---- Setter/Getter Functions -------------------------------------------
+    TempCF setPointCF() const;
+
+  private:
+    TempCF quantize(TempCF tempCF) const;
+
+    PotMap _map;
+    TempCF _stepCF;
+    TempCF _holdCF;              // half a step plus the hysteresis
+    TempCF _setPointCF;
+    uint16_t _lastRaw;
+};
+
+#endif // SETPOINT_KNOB_H
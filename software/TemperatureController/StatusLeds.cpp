@@ -1,4 +1,20 @@
 #include "StatusLeds.h"
+#include <avr/pgmspace.h>
+
+// Sensor fault: orange + blue and green in turn, one per updateLEDs() call.
+// Nothing else ever lights the outer two together without the middle one.
+static const uint8_t FAULT_SEQUENCE[] PROGMEM = {
+  StatusLeds::LED_ABOVE | StatusLeds::LED_BELOW, StatusLeds::LED_IN_BAND
+};
+
+// Boot animation, one pattern per updateLEDs() call (see startSelfTest())
+static const uint8_t SELF_TEST_SEQUENCE[] PROGMEM = {
+  StatusLeds::LED_BELOW, StatusLeds::LED_IN_BAND, StatusLeds::LED_ABOVE,   // Step each LED
+  StatusLeds::LED_ALL,                                                     // All on
+  0,                                                                       // All off
+  StatusLeds::LED_BELOW, StatusLeds::LED_IN_BAND, StatusLeds::LED_ABOVE,   // Step each LED
+  0
+};
 
 /******************************************************************************
  DESCRIPTION: Constructor, using initializer list.
@@ -7,17 +23,54 @@ StatusLeds::StatusLeds(
         uint8_t abovePin,
         uint8_t inBandPin,
         uint8_t belowPin,
-        float hysteresisF,
-        unsigned long updateIntervalMs)
+        float hysteresisF)
       :
       _abovePin(abovePin),
       _inBandPin(inBandPin),
       _belowPin(belowPin),
       _hysteresisF(hysteresisF),
-      _updateIntervalMs(updateIntervalMs),
-      _lastUpdate(0),
+      _halfBandCF(toCF(hysteresisF * 0.5f)),
+      _lowEdgeCF(0),
+      _setPointCF(0),
+      _highEdgeCF(0),
+      _tempCF(0),
+      _band(),
+      _counts(0),
       _region(AtSetPoint),
-      _lastRegion(AtSetPoint)
+      _lastRegion(AtSetPoint),
+      _writer(0),
+      _selfTestStep(SELF_TEST_DONE),
+      _fault(false),
+      _faultBlink(0)
+      {}
+
+/******************************************************************************
+ DESCRIPTION: Constructor for the fixed-point build. The hysteresis band is
+  given in hundredths of a degree F (see FixedTemp.h).
+*******************************************************************************/
+StatusLeds::StatusLeds(
+        uint8_t abovePin,
+        uint8_t inBandPin,
+        uint8_t belowPin,
+        TempCF hysteresisCF)
+      :
+      _abovePin(abovePin),
+      _inBandPin(inBandPin),
+      _belowPin(belowPin),
+      _hysteresisF(0),
+      _halfBandCF(hysteresisCF / 2),
+      _lowEdgeCF(0),
+      _setPointCF(0),
+      _highEdgeCF(0),
+      _tempCF(0),
+      _band(),
+      _counts(0),
+      _region(AtSetPoint),
+      _lastRegion(AtSetPoint),
+      _writer(0),
+      _selfTestStep(SELF_TEST_DONE),
+      _fault(false),
+      _faultBlink(0)
       {}
 
 
@@ -30,9 +83,16 @@ void StatusLeds::begin() {
     pinMode(_inBandPin,  OUTPUT);
     pinMode(_belowPin,   OUTPUT);
 
-    digitalWrite(_abovePin, LOW);
-    digitalWrite(_inBandPin,  LOW);
-    digitalWrite(_belowPin,   LOW);
+    writePattern(0);
+}
+
+/******************************************************************************
+ DESCRIPTION: Send LED output through a port-register writer instead of
+  digitalWrite(). See StatusLedPins in StatusLeds.h. Pass 0 to go back to
+  digitalWrite().
+*******************************************************************************/
+void StatusLeds::setLedWriter(LedWriter writer) {
+  _writer = writer;
 }
 
 /******************************************************************************
@@ -72,6 +132,95 @@ void StatusLeds::setDisplayState(float tempF, float setPointF) {
   }
 }
 
+/******************************************************************************
+ DESCRIPTION: Fixed-point version of setDisplayState(). Same regions as the
+  float version, but temperatures are in hundredths of a degree F.
+
+ NOTES:
+  - Kept for callers that have both values at hand. The tasks use the
+    event-driven setters below instead.
+*******************************************************************************/
+void StatusLeds::setDisplayState(TempCF tempCF, TempCF setPointCF) {
+  if (setPointCF != _setPointCF) setSetPoint(setPointCF);
+  setTemperature(tempCF);
+}
+
+/******************************************************************************
+ DESCRIPTION: Raw-count version of setDisplayState(). Classifies the filtered
+  LM19 reading against the same thresholds the heater control uses, so no
+  temperature conversion is needed here either.
+*******************************************************************************/
+void StatusLeds::setDisplayState(uint16_t counts, const BandThresholds& band) {
+  _band = band;
+  setCounts(counts);
+}
+
+/******************************************************************************
+ DESCRIPTION: A new set-point has been chosen. Work out the band edges for
+  it, then re-check the region against the last temperature we were given.
+*******************************************************************************/
+void StatusLeds::setSetPoint(TempCF setPointCF) {
+  _setPointCF = setPointCF;
+  _lowEdgeCF  = setPointCF - _halfBandCF;
+  _highEdgeCF = setPointCF + _halfBandCF;
+  classifyCF();
+}
+
+/******************************************************************************
+ DESCRIPTION: A new filtered temperature has arrived. Re-check the region.
+*******************************************************************************/
+void StatusLeds::setTemperature(TempCF tempCF) {
+  _tempCF = tempCF;
+  classifyCF();
+}
+
+/******************************************************************************
+ DESCRIPTION: Raw-count twins of setSetPoint()/setTemperature(). The band
+  already holds the edges in LM19 counts (the control task built it), so
+  there is nothing to work out here.
+*******************************************************************************/
+void StatusLeds::setBand(const BandThresholds& band) {
+  _band = band;
+  classifyCounts();
+}
+
+void StatusLeds::setCounts(uint16_t counts) {
+  _counts = counts;
+  classifyCounts();
+}
+
+/******************************************************************************
+ DESCRIPTION: Region classification against the precomputed edges.
+
+ NOTES:
+  - Same regions as the float setDisplayState().
+  - Counts run opposite to temperature (see BandThresholds in FixedTemp.h),
+    which is why every comparison in classifyCounts() is flipped.
+*******************************************************************************/
+void StatusLeds::classifyCF() {
+  if (_tempCF < _lowEdgeCF) {
+    _region = Below;
+  } else if (_tempCF <= _setPointCF) {
+    _region = InBandBelow;
+  } else if (_tempCF <= _highEdgeCF) {
+    _region = InBandAbove;
+  } else {
+    _region = Above;
+  }
+}
+
+void StatusLeds::classifyCounts() {
+  if (_counts > _band.onCounts) {
+    _region = Below;
+  } else if (_counts >= _band.setCounts) {
+    _region = InBandBelow;
+  } else if (_counts >= _band.offCounts) {
+    _region = InBandAbove;
+  } else {
+    _region = Above;
+  }
+}
+
 /******************************************************************************
  DESCRIPTION: Based on the current state of _region make sure the correct 
   status LED is lit.
@@ -79,88 +228,100 @@ void StatusLeds::setDisplayState(float tempF, float setPointF) {
  NOTES:
   - The method setDisplayState() must be called periodically in order to set
     the state of _region.
-  - This is intended to be a non-blocking function that gets called as part of
-    the RTS structure in the application's main loop() function.
+  - This is intended to be a non-blocking function that gets called as one of
+    the application's scheduled tasks; the tempo is set by the task table in
+    the sketch, not here.
+  - While the self-test runs, each call shows its next step instead. Once it
+    is over the region is written whether or not it changed, since the
+    LEDs were showing something else.
+  - A sensor fault (setFault()) comes before everything: each call shows
+    the next step of FAULT_SEQUENCE until it is cleared, and the region is
+    then written as after the self-test.
+  - Returns whether it wrote the LEDs, e.g. so the ADC can keep clear of
+    the edge (see AdcSampler::blank()).
 *******************************************************************************/
-void StatusLeds::updateLEDs(unsigned long now) {
-  if (now - _lastUpdate < _updateIntervalMs) {
-    return;
-  }
-  _lastUpdate = now;
+bool StatusLeds::updateLEDs() {
+  // LED pattern for each Region, in enum order
+  static const uint8_t REGION_PATTERN[] PROGMEM = {
+    LED_BELOW,                  // Below:       below lower bound of band
+    LED_IN_BAND | LED_BELOW,    // InBandBelow: in band, below the setpoint
+    LED_IN_BAND,                // AtSetPoint:  right at the set point
+    LED_IN_BAND | LED_ABOVE,    // InBandAbove: in band, above the setpoint
+    LED_ABOVE                   // Above:       above upper bound of band
+  };
 
-  if (_region == _lastRegion) return; // No status change, nothing to do
-
-  _lastRegion = _region;
+  if (_fault) {
+    _faultBlink = (_faultBlink % sizeof(FAULT_SEQUENCE)) + 1;
+    writePattern(pgm_read_byte(&FAULT_SEQUENCE[_faultBlink - 1]));
+    return true;
+  }
 
-  bool belowOn    = false;
-  bool inBandOn   = false;
-  bool aboveOn    = false;
-
-  switch (_region) {
-    case Below:
-      belowOn = true;   // below lower bound of band
-      break;
-    case InBandBelow:
-      inBandOn = true;  // in hysteresis band
-      belowOn = true;   // and below the setpoint
-      break;
-    case AtSetPoint:
-      inBandOn = true;  // right at the set point
-      break;
-    case InBandAbove:
-      inBandOn = true;  // in hysteresis band
-      aboveOn = true;   // and above the setpoint
-      break;
-    case Above:
-      aboveOn = true;   // above upper bound of setpoint
-      break;
+  if (_selfTestStep != SELF_TEST_DONE) {
+    if (++_selfTestStep < sizeof(SELF_TEST_SEQUENCE)) {
+      writePattern(pgm_read_byte(&SELF_TEST_SEQUENCE[_selfTestStep]));
+      return true;
+    }
+    _selfTestStep = SELF_TEST_DONE;
+    _lastRegion   = _region;
+    writePattern(pgm_read_byte(&REGION_PATTERN[_region]));
+    return true;
   }
 
-  digitalWrite(_abovePin, aboveOn ? HIGH : LOW);
-  digitalWrite(_inBandPin,  inBandOn  ? HIGH : LOW);
-  digitalWrite(_belowPin,   belowOn   ? HIGH : LOW);
+  if (_region == _lastRegion && !_faultBlink) return false; // No status change, nothing to do
+
+  _faultBlink = 0;
+  _lastRegion = _region;
+  writePattern(pgm_read_byte(&REGION_PATTERN[_region]));
+  return true;
 }
 
 
 
 /******************************************************************************
  DESCRIPTION: Self test. Use at boot-up to show that all LEDs are working.
-*******************************************************************************/
-void StatusLeds::selfTest() {
-  uint8_t pins[3] = { _belowPin, _inBandPin, _abovePin };
 
-  // Step each LED
-  for (uint8_t i = 0; i < 3; i++) {
-    digitalWrite(pins[i], HIGH);
-    delay(250);
-    digitalWrite(pins[i], LOW);
-  }
-  // All on
-  digitalWrite(_abovePin, HIGH);
-  digitalWrite(_inBandPin, HIGH);
-  digitalWrite(_belowPin, HIGH);
-  delay(250);
-  // All off
-  digitalWrite(_abovePin, LOW);
-  digitalWrite(_inBandPin, LOW);
-  digitalWrite(_belowPin, LOW);
-  delay(250);
-  // Step each LED
-  for (uint8_t i = 0; i < 3; i++) {
-    digitalWrite(pins[i], HIGH);
-    delay(250);
-    digitalWrite(pins[i], LOW);
-  }
+ NOTES:
+  - Shows the first step and returns; updateLEDs() plays the rest, one step
+    per call, while the rest of the application carries on.
+*******************************************************************************/
+void StatusLeds::startSelfTest() {
+  _selfTestStep = 0;
+  writePattern(pgm_read_byte(&SELF_TEST_SEQUENCE[0]));
 }
 
 
+/******************************************************************************
+ DESCRIPTION: Show (or stop showing) that the temperature sensor has failed.
+
+ NOTES:
+  - Like the self-test, the LED task plays the pattern out; this only says
+    which to show. A self-test still running is cut short, since a fault
+    at boot matters more.
+*******************************************************************************/
+void StatusLeds::setFault(bool fault) {
+  _fault = fault;
+  if (fault) _selfTestStep = SELF_TEST_DONE;
+}
+
 /******************************************************************************
  DESCRIPTION: Turn all LEDs off.
 *******************************************************************************/
 void StatusLeds::allOff() {
-  digitalWrite(_abovePin, LOW);
-  digitalWrite(_inBandPin, LOW);
-  digitalWrite(_belowPin, LOW);
+  writePattern(0);
+}
+
+/******************************************************************************
+ DESCRIPTION: Light exactly the LEDs in pattern (LED_BELOW | LED_IN_BAND |
+  LED_ABOVE), through the port-register writer if one was given.
+*******************************************************************************/
+void StatusLeds::writePattern(uint8_t pattern) {
+  if (_writer) {
+    _writer(pattern);
+    return;
+  }
+  digitalWrite(_abovePin,  (pattern & LED_ABOVE)   ? HIGH : LOW);
+  digitalWrite(_inBandPin, (pattern & LED_IN_BAND) ? HIGH : LOW);
+  digitalWrite(_belowPin,  (pattern & LED_BELOW)   ? HIGH : LOW);
 }
 
 /******************************************************************************
@@ -170,3 +331,7 @@ StatusLeds::Region StatusLeds::region() const {
   return _region; 
 }
 
+bool StatusLeds::selfTestRunning() const {
+  return _selfTestStep != SELF_TEST_DONE;
+}
+
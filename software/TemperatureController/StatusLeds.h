@@ -2,6 +2,8 @@
 #define STATUS_LEDS_H
 
 #include <Arduino.h>
+#include "FixedTemp.h"
+#include "FastPin.h"
 
 /******************************************************************************
  DESCRIPTION: This class is part of the Temperature Controller application.
@@ -16,36 +18,123 @@
       * abovePIN = Orange color LED
       * inBandPIN = Green color LED
       * belowPIN = Blue color LED
+  - In the fixed-point builds the region is event driven: call
+    setSetPoint()/setTemperature() (or setBand()/setCounts() when control
+    works in raw LM19 counts) only when a new set-point or a new filtered
+    sample arrives. The band edges are worked out once per set-point, so each
+    new sample costs at most three integer compares.
+  - startSelfTest() plays a boot animation one step per updateLEDs() call,
+    so it never holds anything up; the region is shown once it is over.
+  - setFault(true) flashes a sensor-fault pattern, the same way, in place of
+    the region until it is cleared (see SensorFault.h).
+  - All LED output goes through one "pattern" byte (LED_BELOW | LED_IN_BAND |
+    LED_ABOVE). By default it is written with digitalWrite(). Hand
+    setLedWriter() a StatusLedPins<...>::write function (below) to have it
+    written straight to the port registers instead.
 *******************************************************************************/
 
 class StatusLeds {
   public:
     enum Region : uint8_t { Below, InBandBelow, AtSetPoint, InBandAbove, Above };
 
+    static const uint8_t LED_BELOW   = 0x01;   // LED pattern bits
+    static const uint8_t LED_IN_BAND = 0x02;
+    static const uint8_t LED_ABOVE   = 0x04;
+    static const uint8_t LED_ALL     = LED_BELOW | LED_IN_BAND | LED_ABOVE;
+    static const uint8_t SELF_TEST_DONE = 0xFF;
+
+    typedef void (*LedWriter)(uint8_t pattern);
+
     // ---- Constructor -------------------------------------------------------
     StatusLeds(
       uint8_t abovePin,
       uint8_t inBandPin,
       uint8_t belowPin,
-      float hysteresisF,
-      unsigned long updateIntervalMs);
+      float hysteresisF);
+    StatusLeds(
+      uint8_t abovePin,
+      uint8_t inBandPin,
+      uint8_t belowPin,
+      TempCF hysteresisCF);
 
     // ---- General Methods ---------------------------------------------------
     void begin();
     void setDisplayState(float tempF, float setPointF);
-    void updateLEDs(unsigned long now);
-    void selfTest();
+    void setDisplayState(TempCF tempCF, TempCF setPointCF);
+    void setDisplayState(uint16_t counts, const BandThresholds& band);
+    void setSetPoint(TempCF setPointCF);
+    void setTemperature(TempCF tempCF);
+    void setBand(const BandThresholds& band);
+    void setCounts(uint16_t counts);
+    bool updateLEDs();
+    void startSelfTest();
+    void setFault(bool fault);
     void allOff();
+    void setLedWriter(LedWriter writer);
 
     // ---- Setter/Getter Functions -------------------------------------------
     Region region() const;
+    bool selfTestRunning() const;
 
   private:
+    void classifyCF();
+    void classifyCounts();
+    void writePattern(uint8_t pattern);
+
     uint8_t _abovePin, _inBandPin, _belowPin;
     float _hysteresisF;
-    unsigned long _updateIntervalMs, _lastUpdate;
+    TempCF _halfBandCF;
+    TempCF _lowEdgeCF, _setPointCF, _highEdgeCF, _tempCF;
+    BandThresholds _band;
+    uint16_t _counts;
     Region _region;
     Region _lastRegion;
+    LedWriter _writer;
+    uint8_t _selfTestStep;      // SELF_TEST_DONE when not running
+    bool _fault;
+    uint8_t _faultBlink;        // FAULT_SEQUENCE step shown + 1; 0 when not showing
+};
+
+/******************************************************************************
+ DESCRIPTION: Port-register LED writer for StatusLeds, built at compile time
+  from three FastPin types (see FastPin.h).
+
+ NOTES:
+  - write() sets all the LEDs that share a port with one masked write to
+    that port (on the current board: one PORTB write for orange + green, one
+    PORTA write for blue). Which LED lives on which port is worked out by
+    the compiler, so a port with no LEDs on it is skipped entirely.
+  - The read-modify-write is done with interrupts off, so an ISR that drives
+    another pin on the same port can't have its change undone.
+  - Usage:
+      typedef StatusLedPins<LedAbovePin, LedInBandPin, LedBelowPin> LedPins;
+      statusLeds.setLedWriter(LedPins::write);
+*******************************************************************************/
+template <class AbovePin, class InBandPin, class BelowPin>
+struct StatusLedPins {
+  static void write(uint8_t pattern) {
+    writePort<PortA>(pattern);
+    writePort<PortB>(pattern);
+  }
+
+  template <class P>
+  static void writePort(uint8_t pattern) {
+    const uint8_t aboveMask  = PortMask<P, AbovePin>::value;
+    const uint8_t inBandMask = PortMask<P, InBandPin>::value;
+    const uint8_t belowMask  = PortMask<P, BelowPin>::value;
+    const uint8_t mask = aboveMask | inBandMask | belowMask;
+    if (mask == 0) return;
+
+    uint8_t bits = 0;
+    if (pattern & StatusLeds::LED_ABOVE)   bits |= aboveMask;
+    if (pattern & StatusLeds::LED_IN_BAND) bits |= inBandMask;
+    if (pattern & StatusLeds::LED_BELOW)   bits |= belowMask;
+
+    uint8_t sreg = SREG;
+    cli();
+    P::out() = (P::out() & (uint8_t)~mask) | bits;
+    SREG = sreg;
+  }
 };
 
 #endif // STATUS_LEDS_H
@@ -0,0 +1,109 @@
+#include "TaskProfiler.h"
+
+// Only build this (and claim the Timer1 overflow vector) when it is used.
+#if TC_PROFILE
+
+TaskProfiler profiler;
+
+// Timer1 is ours unless a heater output mode has taken it.
+#define PROFILE_TIMER1 (TC_OUTPUT_MODE == TC_OUTPUT_HYSTERESIS)
+
+/******************************************************************************
+ DESCRIPTION: Constructor, using initializer list. Nothing touches the
+  hardware until begin().
+*******************************************************************************/
+TaskProfiler::TaskProfiler()
+      :
+      _overflows(0),
+      _overhead(0)
+      {
+        for (uint8_t slot = 0; slot < MAX_SLOTS; slot++) {
+          reset(slot);
+        }
+      }
+
+/******************************************************************************
+ DESCRIPTION: Start the cycle clock and measure what reading it costs.
+*******************************************************************************/
+void TaskProfiler::begin() {
+#if PROFILE_TIMER1
+  TCCR1A = 0;
+  TCCR1B = _BV(CS10);    // normal mode, clk/1
+  TCNT1  = 0;
+  TIFR1  = _BV(TOV1);
+  TIMSK1 |= _BV(TOIE1);
+#endif
+
+  uint32_t start = now();
+  _overhead = (uint8_t)(now() - start);
+}
+
+/******************************************************************************
+ DESCRIPTION: CPU cycles since begin(), wrapping every 2^32 (9 minutes at
+  8 MHz); span lengths come out right across the wrap.
+
+ NOTES:
+  - If Timer1 has overflowed but its interrupt hasn't run yet (we got here
+    with interrupts off, or just as it happened), the pending flag says so.
+    A low count means the overflow came before we read TCNT1.
+*******************************************************************************/
+uint32_t TaskProfiler::now() const {
+#if PROFILE_TIMER1
+  uint8_t sreg = SREG;
+  cli();
+  uint16_t low  = TCNT1;
+  uint16_t high = _overflows;
+  if ((TIFR1 & _BV(TOV1)) && low < 0x8000) high++;
+  SREG = sreg;
+  return ((uint32_t)high << 16) | low;
+#else
+  return micros() * (F_CPU / 1000000UL);
+#endif
+}
+
+/******************************************************************************
+ DESCRIPTION: Add one span, from startCycles (a now() reading) to now, to a
+  slot.
+*******************************************************************************/
+void TaskProfiler::record(uint8_t slot, uint32_t startCycles) {
+  uint32_t cycles = now() - startCycles;
+  cycles = cycles > _overhead ? cycles - _overhead : 0;
+
+  ProfileStats& stats = _stats[slot];
+  if (stats.count == 0xFFFF) return;   // full until it is reported
+
+  stats.count++;
+  stats.totalCycles += cycles;
+  if (cycles < stats.minCycles) stats.minCycles = cycles;
+  if (cycles > stats.maxCycles) stats.maxCycles = cycles;
+}
+
+/******************************************************************************
+ DESCRIPTION: Clear a slot, to start its next reporting window.
+*******************************************************************************/
+void TaskProfiler::reset(uint8_t slot) {
+  ProfileStats& stats = _stats[slot];
+  stats.totalCycles = 0;
+  stats.minCycles   = 0xFFFFFFFFUL;
+  stats.maxCycles   = 0;
+  stats.count       = 0;
+}
+
+void TaskProfiler::onOverflow() {
+  _overflows++;
+}
+
+/******************************************************************************
+ DESCRIPTION: Getter methods
+*******************************************************************************/
+const ProfileStats& TaskProfiler::stats(uint8_t slot) const {
+  return _stats[slot];
+}
+
+#if PROFILE_TIMER1
+ISR(TIM1_OVF_vect) {
+  profiler.onOverflow();
+}
+#endif
+
+#endif // TC_PROFILE
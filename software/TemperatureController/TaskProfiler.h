@@ -0,0 +1,90 @@
+#ifndef TASK_PROFILER_H
+#define TASK_PROFILER_H
+
+#include <Arduino.h>
+#include "BuildOptions.h"
+
+/******************************************************************************
+ DESCRIPTION: Timing of one profiled stretch of code since it was last
+  reported. The average is totalCycles / count.
+*******************************************************************************/
+struct ProfileStats {
+  uint32_t totalCycles;
+  uint32_t minCycles;
+  uint32_t maxCycles;
+  uint16_t count;
+};
+
+/******************************************************************************
+ DESCRIPTION: This class is part of the Temperature Controller application.
+  It times stretches of code (a task, one pass of loop()) in CPU cycles and
+  keeps min/max/average per "slot" in a small fixed table (TC_PROFILE).
+
+ NOTES:
+  - Wrap the code in TC_PROFILE_SPAN(slot) (to the end of the enclosing
+    block) or TC_PROFILE_CALL(slot, statement). Both compile to nothing, or
+    to just the statement, without TC_PROFILE. The sketch numbers the slots.
+  - The clock is Timer1 counting every CPU cycle, stretched to 32 bits by
+    its overflow interrupt (one every 8 ms at 8 MHz). When a heater output
+    mode owns Timer1 it is micros() instead, good to 64 cycles at 8 MHz;
+    that is still plenty to see what a task costs.
+  - The cost of reading the clock is measured once in begin() and taken off
+    every span, so an empty span reads 0.
+  - The sketch reads each slot out with stats() and clears it with reset(),
+    so the figures cover the time since the last report. A slot stops
+    counting once count reaches 0xFFFF, rather than wrap.
+  - There is only one Timer1 overflow, so there is exactly one instance:
+    profiler.
+*******************************************************************************/
+
+#if TC_PROFILE
+
+class TaskProfiler {
+  public:
+    static const uint8_t MAX_SLOTS = 6;   // 14 bytes of RAM each
+
+    TaskProfiler();
+
+    // ---- General Methods ---------------------------------------------------
+    void begin();
+    uint32_t now() const;
+    void record(uint8_t slot, uint32_t startCycles);
+    void reset(uint8_t slot);
+    void onOverflow();          // only called from the Timer1 overflow ISR
+
+    // ---- Setter/Getter Functions -------------------------------------------
+    const ProfileStats& stats(uint8_t slot) const;
+
+  private:
+    ProfileStats _stats[MAX_SLOTS];
+    volatile uint16_t _overflows;   // high half of the Timer1 cycle count
+    uint8_t _overhead;              // cycles an empty span measures
+};
+
+extern TaskProfiler profiler;
+
+/******************************************************************************
+ DESCRIPTION: Times from its construction to the end of its scope and hands
+  that to the profiler. Use it through TC_PROFILE_SPAN().
+*******************************************************************************/
+class ProfileSpan {
+  public:
+    explicit ProfileSpan(uint8_t slot) : _slot(slot), _start(profiler.now()) {}
+    ~ProfileSpan() { profiler.record(_slot, _start); }
+
+  private:
+    uint8_t _slot;
+    uint32_t _start;
+};
+
+#define TC_PROFILE_SPAN(slot)            ProfileSpan profileSpan_(slot)
+#define TC_PROFILE_CALL(slot, statement) do { ProfileSpan profileSpan_(slot); statement; } while (0)
+
+#else
+
+#define TC_PROFILE_SPAN(slot)            do {} while (0)
+#define TC_PROFILE_CALL(slot, statement) do { statement; } while (0)
+
+#endif // TC_PROFILE
+
+#endif // TASK_PROFILER_H
@@ -0,0 +1,75 @@
+#include "TaskScheduler.h"
+
+/******************************************************************************
+ DESCRIPTION: Constructor, using initializer list.
+*******************************************************************************/
+TaskScheduler::TaskScheduler(ScheduledTask* tasks, uint8_t taskCount)
+      :
+      _tasks(tasks),
+      _taskCount(taskCount > MAX_TASKS ? MAX_TASKS : taskCount),
+      _soonMask(0)
+      {}
+
+/******************************************************************************
+ DESCRIPTION: Run every task that is due, then work out how long it is until
+  the next one is.
+
+ NOTES:
+  - Call this continuously from loop(), with now = millis().
+  - Returns 0 if some task is already due again, which only happens when
+    runSoon() was called from inside a task, or a task's interval is shorter
+    than the time the other tasks took to run.
+*******************************************************************************/
+unsigned long TaskScheduler::runDue(unsigned long now) {
+  unsigned long idleMs = 0xFFFFFFFFUL;
+
+  for (uint8_t i = 0; i < _taskCount; i++) {
+    ScheduledTask& task = _tasks[i];
+    unsigned long elapsed = now - task.lastRunMs;
+
+    uint16_t bit = (uint16_t)1 << i;
+    if (elapsed >= task.intervalMs || (_soonMask & bit)) {
+      _soonMask &= ~bit;
+      task.lastRunMs = now;
+      task.run(now);
+      elapsed = 0;
+    }
+
+    unsigned long remaining = task.intervalMs - elapsed;
+    if (remaining < idleMs) idleMs = remaining;
+  }
+
+  if (_soonMask) idleMs = 0;   // a task asked for another one to run soon
+  return idleMs;
+}
+
+/******************************************************************************
+ DESCRIPTION: Make a task due on the very next runDue() call, whatever its
+  interval. Use it when something happens that the task should react to
+  straight away.
+*******************************************************************************/
+void TaskScheduler::runSoon(uint8_t taskId) {
+  if (taskId < _taskCount) _soonMask |= (uint16_t)1 << taskId;
+}
+
+/******************************************************************************
+ DESCRIPTION: Make a task next due delayMs after now (on the same clock
+  runDue() is given), whatever its interval. delayMs should not be more
+  than the interval.
+*******************************************************************************/
+void TaskScheduler::runAfter(uint8_t taskId, unsigned long now, unsigned long delayMs) {
+  if (taskId < _taskCount) {
+    _tasks[taskId].lastRunMs = now + delayMs - _tasks[taskId].intervalMs;
+  }
+}
+
+/******************************************************************************
+ DESCRIPTION: Setter/Getter methods
+*******************************************************************************/
+void TaskScheduler::setInterval(uint8_t taskId, unsigned long intervalMs) {
+  _tasks[taskId].intervalMs = intervalMs;
+}
+
+unsigned long TaskScheduler::interval(uint8_t taskId) const {
+  return _tasks[taskId].intervalMs;
+}
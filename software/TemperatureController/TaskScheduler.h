@@ -0,0 +1,58 @@
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+#include <Arduino.h>
+
+/******************************************************************************
+ DESCRIPTION: This class is part of the Temperature Controller application.
+  It is the "mini-RTS" that used to be spread across the tasks themselves:
+  each task used to carry its own lastXxxMs variable and check
+  "now - lastXxxMs < INTERVAL" on every pass of loop().
+
+ NOTES:
+  - The task table is a plain static array of ScheduledTask owned by the
+    sketch, so its size is fixed at compile time and nothing is allocated.
+  - runSoon() only sets a flag, so it does not care which clock the caller
+    uses; the task runs on the next runDue() call.
+  - runAfter() moves a task's next run instead. Giving two tasks with the
+    same interval different delays keeps them that far out of step, e.g.
+    so their ADC conversions take turns rather than queueing up.
+  - Task functions get the same "now" the scheduler used, and no longer need
+    any timing logic of their own.
+  - runDue() returns how many milliseconds remain until the next task is
+    due. That is how long loop() may idle (or sleep) without making any task
+    late.
+  - A task runs at most once per runDue() call and, like the original
+    hand-rolled checks, its next deadline is measured from when it actually
+    ran. A late task does not try to "catch up".
+*******************************************************************************/
+
+struct ScheduledTask {
+  void (*run)(unsigned long now);
+  unsigned long intervalMs;
+  unsigned long lastRunMs;
+};
+
+class TaskScheduler {
+  public:
+    // ---- Constructor -------------------------------------------------------
+    TaskScheduler(ScheduledTask* tasks, uint8_t taskCount);
+
+    static const uint8_t MAX_TASKS = 16;   // bits in _soonMask
+
+    // ---- General Methods ---------------------------------------------------
+    unsigned long runDue(unsigned long now);
+    void runSoon(uint8_t taskId);
+    void runAfter(uint8_t taskId, unsigned long now, unsigned long delayMs);
+
+    // ---- Setter/Getter Functions -------------------------------------------
+    void setInterval(uint8_t taskId, unsigned long intervalMs);
+    unsigned long interval(uint8_t taskId) const;
+
+  private:
+    ScheduledTask* _tasks;
+    uint8_t _taskCount;
+    uint16_t _soonMask;       // bit n set = run task n on the next runDue()
+};
+
+#endif // TASK_SCHEDULER_H
@@ -0,0 +1,121 @@
+#include "BuildOptions.h"
+#include "TelemetryTx.h"
+
+// Only build this (and claim the Timer0 compare B vector) when it is used.
+#if TC_TELEMETRY
+
+TelemetryTx telemetryTx;
+
+const uint8_t TelemetryTx::SYNC;   // push() takes it by reference
+
+/******************************************************************************
+ DESCRIPTION: Constructor, using initializer list. Nothing touches the
+  hardware until begin().
+*******************************************************************************/
+TelemetryTx::TelemetryTx()
+      :
+      _port(0),
+      _mask(0),
+      _bitTicks(0),
+      _seq(0),
+      _shift(0),
+      _bitsLeft(0),
+      _active(false)
+      {}
+
+/******************************************************************************
+ DESCRIPTION: Take over the TX pin and idle it high (the serial "mark"
+  state). bitTicks is bitTicks(baud).
+*******************************************************************************/
+void TelemetryTx::begin(uint8_t pin, uint8_t bitTicks) {
+  _port     = portOutputRegister(digitalPinToPort(pin));
+  _mask     = digitalPinToBitMask(pin);
+  _bitTicks = bitTicks;
+
+  digitalWrite(pin, HIGH);
+  pinMode(pin, OUTPUT);
+
+  // The core leaves Timer0 in fast PWM, where OCR0B only takes a new value
+  // at the bottom of each count. Normal mode takes it at once, and still
+  // overflows at 0xFF, so millis() and the ADC trigger don't notice.
+  TCCR0A &= ~(_BV(WGM01) | _BV(WGM00) | _BV(COM0B1) | _BV(COM0B0));
+}
+
+/******************************************************************************
+ DESCRIPTION: Queue one frame (see the class notes for the layout). Returns
+  false, and queues nothing, if the buffer hasn't room for all of it.
+*******************************************************************************/
+bool TelemetryTx::sendFrame(uint8_t type, const void* payload, uint8_t length) {
+  if (_buffer.space() < length + 5) return false;
+
+  const uint8_t* bytes = (const uint8_t*)payload;
+  uint8_t sum = type + length + _seq;
+
+  _buffer.push(SYNC);
+  _buffer.push(type);
+  _buffer.push(length);
+  _buffer.push(_seq);
+  for (uint8_t i = 0; i < length; i++) {
+    _buffer.push(bytes[i]);
+    sum += bytes[i];
+  }
+  _buffer.push((uint8_t)~sum);
+  _seq++;
+
+  // Start the bit clock if it had run down. The ISR only stops it once the
+  // buffer is empty, so there is no race with it here.
+  if (!_active) {
+    uint8_t sreg = SREG;
+    cli();
+    _active   = true;
+    _bitsLeft = 0;
+    OCR0B     = TCNT0 + _bitTicks;
+    TIFR0     = _BV(OCF0B);
+    TIMSK0   |= _BV(OCIE0B);
+    SREG = sreg;
+  }
+  return true;
+}
+
+/******************************************************************************
+ DESCRIPTION: One bit time has passed: put the next bit on the pin.
+
+ NOTES:
+  - The line is set first thing, so every bit edge has the same interrupt
+    latency and the bit times stay even.
+  - After a byte's stop bit, the next byte's start bit follows at once if
+    there is one; otherwise the interrupt turns itself off.
+*******************************************************************************/
+void TelemetryTx::onBitTime() {
+  if (_bitsLeft > 1) {
+    // data bits, LSB first
+    if (_shift & 0x01) *_port |= _mask;
+    else               *_port &= (uint8_t)~_mask;
+    _shift >>= 1;
+    _bitsLeft--;
+  } else if (_bitsLeft == 1) {
+    *_port |= _mask;   // stop bit
+    _bitsLeft = 0;
+  } else if (_buffer.pop(_shift)) {
+    *_port &= (uint8_t)~_mask;   // start bit
+    _bitsLeft = 9;               // then 8 data bits and the stop bit
+  } else {
+    TIMSK0 &= ~_BV(OCIE0B);      // line stays high (idle)
+    _active = false;
+    return;
+  }
+  OCR0B += _bitTicks;
+}
+
+/******************************************************************************
+ DESCRIPTION: Getter methods
+*******************************************************************************/
+bool TelemetryTx::isIdle() const {
+  return !_active;
+}
+
+ISR(TIM0_COMPB_vect) {
+  telemetryTx.onBitTime();
+}
+
+#endif // TC_TELEMETRY
@@ -0,0 +1,118 @@
+#ifndef TELEMETRY_TX_H
+#define TELEMETRY_TX_H
+
+#include <Arduino.h>
+#include "BuildOptions.h"
+#include "RingBuffer.h"
+
+/******************************************************************************
+ DESCRIPTION: This class is part of the Temperature Controller application.
+  It sends small framed binary packets out of a spare pin as plain 8N1
+  serial, for a USB-serial adapter on the bench. It only transmits.
+
+ NOTES:
+  - The bits are clocked out by the Timer0 compare B interrupt, one per
+    interrupt, from a 16-byte buffer (64 with TC_PROFILE, so a profile
+    frame fits beside a status frame). Timer0 is already running for
+    millis(), so this takes no timer away from the heater outputs, and
+    sendFrame() only ever copies into the buffer: nothing waits on the
+    serial line.
+  - Timer0 is assumed to tick at clk/64, as ATTinyCore sets it up at 8 and
+    16 MHz. The bit time is a whole number of those ticks; bitTicks() picks
+    it, and the sketch checks the baud rate error at compile time.
+  - begin() switches Timer0 from fast PWM to normal mode, so analogWrite()
+    on its pins (PB2, PA7) stops working. Neither is used for PWM here.
+  - Frame layout:  0xA5, type, length, seq, payload[length], check
+      * seq counts frames, so the receiver can spot lost ones.
+      * check is the 8-bit sum of everything from type to the end of the
+        payload, inverted.
+    Payloads are little-endian, as the AVR stores them.
+  - If a frame doesn't fit in the buffer right now it is dropped whole
+    (sendFrame() returns false); a receiver never sees half a frame.
+  - There is only one Timer0 compare B, so there is exactly one instance:
+    telemetryTx.
+*******************************************************************************/
+
+// Frame types
+const uint8_t TELEMETRY_STATUS    = 0x01;
+const uint8_t TELEMETRY_PROFILE   = 0x02;   // TC_PROFILE
+const uint8_t TELEMETRY_FOOTPRINT = 0x03;   // BENCH_Controller
+
+/******************************************************************************
+ DESCRIPTION: Payload of a TELEMETRY_STATUS frame.
+
+ NOTES:
+  - flags: bit 0 = heaterOn, bit 1 = inDeadband, bit 2 = an LM19 has
+    failed (TC_SENSOR_FAULT), bits 4..6 = the StatusLeds::Region.
+  - awakePermille: IdleSleep::dutyPermille(), the share of its last ~10 s
+    window the CPU was awake, in parts per thousand (0 until the first
+    window closes).
+*******************************************************************************/
+struct TelemetryStatus {
+  int16_t tempCF;
+  int16_t setPointCF;
+  uint8_t flags;
+  uint8_t duty;
+  uint16_t awakePermille;
+};
+
+/******************************************************************************
+ DESCRIPTION: Payload of a TELEMETRY_PROFILE frame: one TaskProfiler slot's
+  figures since its previous frame (see TaskProfiler.h).
+*******************************************************************************/
+struct TelemetryProfile {
+  uint8_t  slot;
+  uint16_t count;
+  uint32_t minCycles;
+  uint32_t maxCycles;
+  uint32_t totalCycles;
+};
+
+/******************************************************************************
+ DESCRIPTION: Payload of a TELEMETRY_FOOTPRINT frame: how much of the chip a
+  BENCH_Controller build takes, from the linker's own symbols.
+
+ NOTES:
+  - flashBytes: program plus initialised data. staticRamBytes: .data plus
+    .bss. freeRamBytes: what is left between .bss and the stack when sent.
+*******************************************************************************/
+struct TelemetryFootprint {
+  uint8_t  variant;
+  uint16_t flashBytes;
+  uint16_t staticRamBytes;
+  uint16_t freeRamBytes;
+};
+
+class TelemetryTx {
+  public:
+    static const uint8_t BUFFER_SIZE = TC_PROFILE ? 64 : 16;
+    static const uint8_t SYNC = 0xA5;
+
+    static constexpr uint8_t bitTicks(uint32_t baud) {
+      return (uint8_t)((F_CPU / 64 + baud / 2) / baud);
+    }
+
+    TelemetryTx();
+
+    // ---- General Methods ---------------------------------------------------
+    void begin(uint8_t pin, uint8_t bitTicks);
+    bool sendFrame(uint8_t type, const void* payload, uint8_t length);
+    void onBitTime();           // only called from the Timer0 compare B ISR
+
+    // ---- Setter/Getter Functions -------------------------------------------
+    bool isIdle() const;
+
+  private:
+    RingBuffer<uint8_t, BUFFER_SIZE> _buffer;
+    volatile uint8_t* _port;
+    uint8_t _mask;
+    uint8_t _bitTicks;
+    uint8_t _seq;
+    uint8_t _shift;             // ISR only: byte going out
+    uint8_t _bitsLeft;          // ISR only: data + stop bits still to send
+    volatile bool _active;      // compare B interrupt is running
+};
+
+extern TelemetryTx telemetryTx;
+
+#endif // TELEMETRY_TX_H
@@ -11,12 +11,102 @@
  CHANGE LOG:
 
  2025-12-06: initial creation (with help from ChatGPT).
+ 2026-10-14: Added the integer-only (fixed-point) temperature pipeline,
+             selected by TC_FIXED_POINT in BuildOptions.h.
+ 2026-10-14: Added TC_COUNT_THRESHOLDS: control and LEDs compare raw LM19
+             counts against thresholds rebuilt only when the pot moves.
+ 2026-10-14: Added TC_ADC_INTERRUPT: the ADC runs in the background (see
+             AdcSampler) and the tasks drain its buffered readings.
+ 2026-10-14: Added TC_ADC_NOISE_SLEEP: LM19 readings are taken in ADC Noise
+             Reduction sleep.
+ 2026-10-14: Tasks are now run from a static task table by TaskScheduler
+             instead of each checking millis() itself.
+ 2026-10-14: loop() now sleeps between tasks (see IdleSleep, TC_IDLE_SLEEP).
+ 2026-10-14: The LED region is only re-worked when a new sample or a new
+             set-point arrives, instead of on every pass of loop().
+ 2026-10-14: Added TC_FAST_PINS: SSR and LEDs written through the port
+             registers; the SSR is only written when its state changes.
+ 2026-10-14: Added TC_OUTPUT_TIME_PROPORTIONAL: the SSR is run as slow PWM
+            off Timer1 (see TimeProportionalOutput), with the on-fraction
+            set proportionally across the hysteresis band.
+ 2026-10-14: Added TC_CONTROL_PID: an integer PID controller (see
+            PidController) sets the time-proportional duty.
+ 2026-10-14: Added TC_OUTPUT_PHASE_ANGLE: triac phase-angle output synced
+            to a zero-cross input on ZC_PIN (see PhaseAngleOutput).
+ 2026-10-14: Added TC_AUTOTUNE: boot with the pot fully up to tune the PID
+            by relay feedback (see RelayAutotune). PID gains are kept in
+            EEPROM (see EepromRecord).
+ 2026-10-14: Added TC_EEPROM_LOG: a wear-leveled history of temperature,
+            set-point and heater duty in EEPROM (see EepromLog).
+ 2026-10-14: Added TC_TELEMETRY: a binary status frame every second out of
+            TELEMETRY_PIN, sent bit by bit from a timer ISR (see TelemetryTx).
+ 2026-10-14: Added TC_PROFILE: the tasks and loop() are timed in CPU cycles
+            (see TaskProfiler) and reported in telemetry frames.
+ 2026-10-14: Fixed-point builds read the LM19 through a PROGMEM table of its
+            datasheet curve instead of the straight-line fit.
+ 2026-10-14: Added TC_ADC_DECIMATE: LM19 samples of 4^n background readings
+            decimated to n extra bits of resolution.
+ 2026-10-14: Added TC_ADC_INTERNAL_REF: the LM19 is read through a divider
+            against the 1.1 V bandgap; the pot stays on Vcc.
+ 2026-10-14: The LED self-test is now played out by the LED task instead of
+            holding up setup(), and the filter and set-point are seeded from
+            real readings, so control starts on the first pass of loop().
+ 2026-10-14: Added TC_ADAPTIVE_SAMPLING: the LM19 is sampled less often
+            while the temperature is steady and clear of the band edges.
+ 2026-10-14: Added TC_ALPHA_BETA: an alpha-beta estimator (see
+            AlphaBetaFilter) can take the place of the EMA.
+ 2026-10-14: Added TC_PREDICTIVE_CUTOFF: the on/off control learns how far
+            the box coasts past each switch and switches that much early
+            (see OvershootPredictor). The leads are kept in EEPROM.
+ 2026-10-14: The set-point now comes from SetpointKnob: quantized to
+            SET_STEP_F steps with hysteresis against pot jitter, and only
+            passed on when it changes. Fixed setPointF going stale while
+            the pot was in the bottom half of its travel.
+ 2026-10-14: Added TC_ZONES: a second on/off zone with its own LM19 and SSR
+            (see ControlZone), sampled half a period out of step with the
+            first.
+ 2026-10-14: The set-point range, band, filter and task intervals now come
+            from a compile-time profile chosen by TC_APP (see AppProfile):
+            the wood dryer as before, a bread proofer, or the bench set-up.
+ 2026-10-14: The LM19 is read through the shared header-only driver in
+            software/libraries/LM19 (datasheet curve, lookup table,
+            blocking and float reads), which the POC and TEST sketches now
+            use too.
+ 2026-10-14: Added TC_SENSOR_FAULT: raw LM19 readings on a rail, moving
+            impossibly fast or stuck while heating shut the heater off from
+            the sampling task and flash a fault pattern (see SensorFault).
+            Added TC_WATCHDOG: the hardware watchdog supervises loop().
+ 2026-10-14: Added TC_ADC_BLANKING: ADC readings are dropped for a moment
+            after each SSR edge or LED change. Added TC_ADC_VCC_COMP: LM19
+            samples are corrected for supply droop from a bandgap reading.
 *******************************************************************************/
 
 
 //=============================================================================
 //==== INCLUDES ===============================================================
+#include "BuildOptions.h"
+#include "FixedTemp.h"
+#include "AppProfile.h"
+#include "ControlMath.h"
 #include "StatusLeds.h"
+#include "AdcSampler.h"
+#include "TaskScheduler.h"
+#include "IdleSleep.h"
+#include "TimeProportionalOutput.h"
+#include "PhaseAngleOutput.h"
+#include "PidController.h"
+#include "RelayAutotune.h"
+#include "EepromRecord.h"
+#include "EepromLog.h"
+#include "TelemetryTx.h"
+#include "TaskProfiler.h"
+#include "AlphaBetaFilter.h"
+#include "OvershootPredictor.h"
+#include "SetpointKnob.h"
+#include "ControlZone.h"
+#include "SensorFault.h"
+#include <LM19.h>
+#include <avr/wdt.h>
 
 //=============================================================================
 //==== INITIALIZATION SECTION =================================================
@@ -27,76 +117,503 @@ const uint8_t SSR_PIN         = PIN_PB0;  // physical pin  2 - SSR control (digi
 const uint8_t LED_ABOVE_PIN   = PIN_PB1;  // physical pin  3 - status LED
 const uint8_t LED_INBAND_PIN  = PIN_PB2;  // physical pin  5 - status LED
 const uint8_t LED_BELOW_PIN   = PIN_PA0;  // physical pin 13 - status LED
+const uint8_t ZC_PIN          = PIN_PA1;  // physical pin 12 - zero-cross input (TC_OUTPUT_PHASE_ANGLE)
+const uint8_t TELEMETRY_PIN   = PIN_PA2;  // physical pin 11 - serial TX out (TC_TELEMETRY)
+const uint8_t ZONE2_SSR_PIN   = PIN_PA5;  // physical pin  8 - second zone's SSR (TC_ZONES = 2)
+
+// ---------------- Same Pins, as Port/Bit for the Port-Register Path ---------
+// Keep these in step with the Arduino pin numbers above (see FastPin.h).
+typedef FastPin<PortB, 0> SsrPin;         // SSR_PIN        = PB0
+typedef FastPin<PortB, 1> LedAbovePin;    // LED_ABOVE_PIN  = PB1
+typedef FastPin<PortB, 2> LedInBandPin;   // LED_INBAND_PIN = PB2
+typedef FastPin<PortA, 0> LedBelowPin;    // LED_BELOW_PIN  = PA0
+typedef StatusLedPins<LedAbovePin, LedInBandPin, LedBelowPin> LedPins;
+typedef FastPin<PortA, 5> Zone2SsrPin;    // ZONE2_SSR_PIN  = PA5
 
 // ---------------- Analog Pin Assignments: using Ax form for ADC -------------
 const uint8_t TEMP_PIN  = A7;       // PA7, physical pin 6 - LM19 Vout
 const uint8_t POT_PIN   = A3;       // PA3, physical pin 10 - pot wiper
+const uint8_t ZONE2_TEMP_PIN = A6;  // PA6, physical pin 7 - second zone's LM19 Vout (TC_ZONES = 2)
+
+// ---------------- ADC Channels: the MUX numbers used by AdcSampler ------------
+#if TC_ADC_INTERNAL_REF
+const uint8_t TEMP_ADC_CH       = 7 | AdcSampler::REF_1V1;  // ADC7 = PA7 = TEMP_PIN, on the bandgap
+const uint8_t ZONE2_TEMP_ADC_CH = 6 | AdcSampler::REF_1V1;  // ADC6 = PA6 = ZONE2_TEMP_PIN, same divider
+const uint8_t TEMP_SLEEP_SAMPLES = 2; // LM19 readings per sample in noise-reduction sleep
+#else
+const uint8_t TEMP_ADC_CH       = 7;  // ADC7 = PA7 = TEMP_PIN
+const uint8_t ZONE2_TEMP_ADC_CH = 6;  // ADC6 = PA6 = ZONE2_TEMP_PIN
+const uint8_t TEMP_SLEEP_SAMPLES = 4; // LM19 readings per sample in noise-reduction sleep
+#endif
+const uint8_t POT_ADC_CH        = 3;  // ADC3 = PA3 = POT_PIN
+const uint8_t ADC_BLOCK_SAMPLES = 32; // readings the ISR sums per buffered block
+const uint8_t TEMP_DECIMATE_BITS = 4; // extra bits from 4^n readings per sample (TC_ADC_DECIMATE)
+const uint8_t SSR_BLANK_MS      = 20; // no readings this long after an SSR edge (TC_ADC_BLANKING);
+                                      // a zero-cross SSR switches up to a half-cycle after it
+const uint8_t LED_BLANK_MS      = 2;  // ...and after an LED change: a few mA, settles fast
+const uint8_t VCC_SAMPLES       = 8;  // bandgap readings per LM19 sample (TC_ADC_VCC_COMP)
 
 // ---------------- LM19 Constants --------------------------------------------
-const float VREF        = 5.0;
-const float LM19_V0C    = 1.8663;
-const float LM19_SLOPE  = 0.01169;   // V/°C; T = (1.8663 - V)/0.01169
+#if TC_ADC_INTERNAL_REF
+// LM19 Vout - LM19_DIV_TOP - TEMP_PIN - LM19_DIV_BOTTOM - GND, read against
+// the 1.1 V bandgap: 2.0 V (-12 °C) is full scale and a count is ~2 mV of
+// LM19 output instead of ~4.9 mV. The bandgap is only good to +/-10% from
+// part to part, so measure ADC_REF_V on the board and put it here. The
+// divider is ~45 kΩ as seen from the pin, so give TEMP_PIN a 100 nF cap to
+// ground for the ADC's sample-and-hold to draw on.
+constexpr float ADC_REF_V       = 1.1;
+constexpr float LM19_DIV_TOP    = 82.0;    // kΩ
+constexpr float LM19_DIV_BOTTOM = 100.0;   // kΩ
+#else
+constexpr float ADC_REF_V       = 5.0;     // Vcc
+constexpr float LM19_DIV_TOP    = 0.0;     // no divider
+constexpr float LM19_DIV_BOTTOM = 1.0;
+#endif
+// LM19 volts at ADC full scale. Every counts-to-temperature constant,
+// float or fixed-point, is worked out from this one.
+constexpr float VREF        = ADC_REF_V * (LM19_DIV_TOP + LM19_DIV_BOTTOM) / LM19_DIV_BOTTOM;
+const uint8_t   N_SAMPLES   = 8;         // LM19 readings averaged per sample
+const uint8_t   TEMP_SEED_BURSTS = 4;    // N_SAMPLES bursts that seed the filter in setup()
+
+// The LM19s, through the shared driver (see LM19.h), which has the
+// datasheet curve and its lookup table. Keep the channels in step with the
+// pins above.
+struct BoardLm19 {
+  static constexpr float FULL_SCALE_V = VREF;
+  static const bool INTERNAL_REF = TC_ADC_INTERNAL_REF;
+};
+typedef Lm19<7, BoardLm19, N_SAMPLES> TempSensor;    // ADC7 = TEMP_PIN
+typedef Lm19<6, BoardLm19, N_SAMPLES> Zone2Sensor;   // ADC6 = ZONE2_TEMP_PIN (TC_ZONES = 2)
 
 // ---------------- Setpoint Range --------------------------------------------
-const float MIN_SET_F   = 50.0;      // bottom of pot
-const float MAX_SET_F   = 90.0;      // top of pot
-const float MID_SET_F   = 72.0;      // desired midpoint temperature
+// The range, band, filter and intervals come from the TC_APP profile (see
+// AppProfile.h); change them there, not here.
+constexpr float MIN_SET_F   = APP.minSetF;   // bottom of pot
+constexpr float MAX_SET_F   = APP.maxSetF;   // top of pot
+constexpr float MID_SET_F   = APP.midSetF;   // desired midpoint temperature
+constexpr float SET_STEP_F  = APP.setStepF;  // set-point moves in steps of this...
+constexpr float SET_HYST_F  = 0.1;       // ...once the pot is this far past a step's edge
+constexpr float ZONE2_OFFSET_F = 0.0;    // second zone's set-point less the pot's (TC_ZONES = 2)
+
+// The pot mapping (MIN_SET_CF .. MAX_SET_CF, potToSetpointCF()) is in
+// ControlMath.h, shared with the bench; every build uses it.
+constexpr TempCF   SET_STEP_CF     = toCF(SET_STEP_F);
+constexpr TempCF   ZONE2_OFFSET_CF = toCF(ZONE2_OFFSET_F);
+
+static_assert(SET_STEP_CF > 0 && MIN_SET_CF % SET_STEP_CF == 0 && MAX_SET_CF % SET_STEP_CF == 0,
+              "The set-point range should start and end on whole SET_STEP_F steps");
+static_assert(SET_HYST_F < SET_STEP_F / 2, "SET_HYST_F would hold the set-point more than a step");
 
 // ---------------- Control Tuning --------------------------------------------
-const float HYST_F      = 2.0;       // hysteresis band (°F)
-const float TEMP_ALPHA  = 0.1;       // EMA factor for filtered temp
+constexpr float HYST_F      = APP.hystF;     // hysteresis band (°F)
+constexpr float TEMP_ALPHA  = APP.tempAlpha; // EMA factor for filtered temp
+// Alpha-beta estimator (TC_ALPHA_BETA): AB_ALPHA smooths the reading about
+// as much as TEMP_ALPHA; AB_BETA is the rate gain, the Benedict-Bordner
+// match for AB_ALPHA (quick without ringing).
+constexpr float AB_ALPHA    = 0.1;
+constexpr float AB_BETA     = AB_ALPHA * AB_ALPHA / (2.0f - AB_ALPHA);
+const uint16_t  SSR_WINDOW_MS = 5000;    // time-proportional window; 2000..10000 suits an SSR
+
+static_assert(SSR_WINDOW_MS >= 2000 && SSR_WINDOW_MS <= 10000,
+              "SSR_WINDOW_MS should be 2..10 s");
+
+// PID tuning (TC_CONTROL_PID), in the usual "standard form" units
+constexpr float PID_KP_PCT  = 50.0;      // % output per °F of error
+constexpr float PID_TI_S    = 300.0;     // integral time (s)
+constexpr float PID_TD_S    = 10.0;      // derivative time (s)
+const uint16_t  AUTOTUNE_POT_MIN = 1000; // pot at least this high at boot = autotune (TC_AUTOTUNE)
+
+#if TC_FIXED_POINT
+// ---------------- Fixed-Point Constants -------------------------------------
+// Everything below is worked out by the compiler from the float constants
+// above; none of it costs flash or cycles on the ATtiny.
+//
+// The LM19 is read through TempSensor's table of its datasheet curve, so
+// the fixed-point builds get the curve, not the straight-line fit, for the
+// cost of two table reads and a multiply-shift.
+//
+// Positions in the table are the N_SAMPLES sum of LM19 readings with
+// LM19_SUM_FRAC fraction bits (max 8184 << 3 = 65472, still a uint16_t).
+// That is the scale readTemperaturePos() hands back, and the scale the
+// count-threshold filter works in.
+constexpr uint8_t  LM19_SUM_FRAC = TempSensor::SUM_FRAC;
+
+// The 0.2 V .. 2.8 V sanity clamp, as table positions (see LM19.h)
+constexpr uint16_t LM19_MIN_POS  = TempSensor::MIN_POS;
+constexpr uint16_t LM19_MAX_POS  = TempSensor::MAX_POS;
+
+// HYST_CF, HALF_BAND_CF and TEMP_ALPHA_Q8 are in ControlMath.h.
+
+// PID gains, from the standard-form tuning above. The controller runs once
+// per CONTROL_UPDATE_MS and its output is a 0..255 duty.
+constexpr float    PID_DT_S        = 1.0f;   // = CONTROL_UPDATE_MS / 1000, checked below
+constexpr float    PID_KP_DUTY_CF  = PID_KP_PCT / 100.0f * 255.0f / 100.0f;
+constexpr PidGains PID_GAINS       = {
+  (uint16_t)(PID_KP_DUTY_CF * 256.0f + 0.5f),
+  (uint16_t)(PID_KP_DUTY_CF * PID_DT_S / PID_TI_S * 65536.0f + 0.5f),
+  (uint16_t)(PID_KP_DUTY_CF * PID_TD_S / PID_DT_S * 256.0f + 0.5f) };
+
+static_assert(PID_KP_DUTY_CF * 256.0f < 65536.0f &&
+              PID_KP_DUTY_CF * PID_TD_S / PID_DT_S * 256.0f < 65536.0f,
+              "PID gains don't fit 16 bits");
+static_assert(PID_GAINS.kiQ16 > 0 || PID_TI_S == 0.0f,
+              "PID_TI_S is too long for the integral gain's resolution");
+
+constexpr uint8_t  AB_ALPHA_Q8     = (uint8_t)(AB_ALPHA * 256.0f + 0.5f);
+constexpr uint16_t AB_BETA_Q16     = (uint16_t)(AB_BETA * 65536.0f + 0.5f);
+static_assert(AB_ALPHA_Q8 > 0 && AB_BETA_Q16 > 0, "AB_ALPHA is too small for the estimator's fractions");
+static_assert(AB_BETA < 0.25f, "AB_BETA must stay below 0.25 (see AlphaBetaFilter.h)");
+
+// LM19 reading at a temperature, in table-position units, straight from
+// the datasheet curve. Like toCF(), for constants only.
+constexpr uint16_t lm19ConstPos(TempCF tempCF) {
+  return TempSensor::constPos(tempCF);
+}
+#endif
+
+#if TC_COUNT_THRESHOLDS
+// ---------------- Count-Threshold Constants ---------------------------------
+// The filtered LM19 reading is kept in table-position units: the N_SAMPLES
+// sum with LM19_SUM_FRAC extra fraction bits, so the EMA does not stall a
+// whole count short. countsToCF()/makeBand() move between that scale and
+// TempCF through the LM19 table.
+static_assert(lm19ConstPos(toCF(MIN_SET_F - HYST_F)) <= LM19_MAX_POS &&
+              lm19ConstPos(toCF(MAX_SET_F + HYST_F)) >= LM19_MIN_POS,
+              "Set-point range runs past the LM19 clamp");
+#endif
+
+#if TC_ADAPTIVE_SAMPLING
+// ---------------- Adaptive Sampling -----------------------------------------
+// The LM19 is sampled every TEMP_SAMPLE_MS << sampleShift (see
+// adaptSampleInterval()). The EMA is meant to have the same time constant
+// at every interval, so alpha for n base intervals at once is
+// 1 - (1 - TEMP_ALPHA)^n; the table has it for each shift.
+const uint8_t   TEMP_SAMPLE_MAX_SHIFT = 4;   // slowest: TEMP_SAMPLE_MS << 4 = 4 s
+constexpr float SAMPLE_NEAR_F         = 1.0; // this close to a band edge: full rate
+const uint8_t   SAMPLE_MARGIN         = 4;   // ...or the edge is this many samples away at the current pace
+#if TC_ALPHA_BETA
+// The estimator's gains are per sample, so its lag grows with the interval;
+// past 2 s it trails the band edges enough to widen the swing.
+const uint8_t   SAMPLE_SLOWEST_SHIFT  = 3;
+#else
+const uint8_t   SAMPLE_SLOWEST_SHIFT  = TEMP_SAMPLE_MAX_SHIFT;
+#endif
+
+constexpr float emaKeep(uint8_t shift) {
+  return shift == 0 ? 1.0f - TEMP_ALPHA : emaKeep(shift - 1) * emaKeep(shift - 1);
+}
+
+constexpr uint8_t emaAlphaQ8At(uint8_t shift) {
+  return (uint8_t)((1.0f - emaKeep(shift)) * 256.0f + 0.5f);
+}
+
+const uint8_t TEMP_ALPHA_Q8_AT[] PROGMEM = {
+  emaAlphaQ8At(0), emaAlphaQ8At(1), emaAlphaQ8At(2), emaAlphaQ8At(3), emaAlphaQ8At(4) };
+
+static_assert(sizeof(TEMP_ALPHA_Q8_AT) == TEMP_SAMPLE_MAX_SHIFT + 1,
+              "TEMP_ALPHA_Q8_AT needs one entry per sample shift");
+static_assert((1.0f - emaKeep(TEMP_SAMPLE_MAX_SHIFT)) * 256.0f + 0.5f < 256.0f,
+              "TEMP_ALPHA is too big to stretch to the slowest sample interval");
+
+#if TC_COUNT_THRESHOLDS
+// SAMPLE_NEAR_F in filteredCounts units, at the middle of the pot
+constexpr int16_t SAMPLE_NEAR = lm19ConstPos(MID_SET_CF - toCF(SAMPLE_NEAR_F)) - lm19ConstPos(MID_SET_CF);
+#else
+constexpr int16_t SAMPLE_NEAR = toCF(SAMPLE_NEAR_F);
+#endif
+#endif
 
 // ---------------- Task Intervals --------------------------------------------
-const unsigned long TEMP_SAMPLE_MS    =  250; // how often to sample LM19
-const unsigned long CONTROL_UPDATE_MS = 1000; // how often to update heater
+const unsigned long TEMP_SAMPLE_MS    = APP.tempSampleMs;    // how often to sample LM19
+const unsigned long CONTROL_UPDATE_MS = APP.controlUpdateMs; // how often to update heater
 const unsigned long LED_UPDATE_MS     =  200; // how often to update the status LEDs
+const unsigned long LOG_SAMPLE_MS     = 1000; // how often to add to the history log
+const uint8_t       LOG_RECORD_MIN    =   10; // minutes averaged into each log record
+const unsigned long TELEMETRY_MS      = 1000; // how often to send a status frame
+
+#if TC_SENSOR_FAULT
+// ---------------- Sensor Fault ----------------------------------------------
+// What SensorFault takes for a failed LM19. A fault clears after
+// FAULT_CLEAR_SAMPLES good readings in a row (2 s at TEMP_SAMPLE_MS).
+constexpr float FAULT_STEP_F        = 5.0;     // most the box can move in one sample (°F)
+const uint32_t  FAULT_STUCK_MS      = 300000;  // not one count of change, heating full, for this long
+const uint8_t   FAULT_CLEAR_SAMPLES = 8;
+
+// In the units the readings come in (table positions)
+constexpr uint16_t FAULT_STEP_POS      = lm19ConstPos(MID_SET_CF) - lm19ConstPos(MID_SET_CF + toCF(FAULT_STEP_F));
+constexpr uint16_t FAULT_STUCK_SAMPLES = FAULT_STUCK_MS / TEMP_SAMPLE_MS;
+static_assert(FAULT_STUCK_MS / TEMP_SAMPLE_MS < 65536, "FAULT_STUCK_MS is too many samples");
+#endif
+
+// ---------------- Watchdog --------------------------------------------------
+// loop() comes round at least every LED_UPDATE_MS, so this is five missed
+// passes. An avr/wdt.h WDTO_ constant.
+const uint8_t WATCHDOG_TIMEOUT = WDTO_1S;
+
+// ---------------- Telemetry -------------------------------------------------
+const uint32_t TELEMETRY_BAUD      = 9600;
+constexpr uint8_t TELEMETRY_BIT_TICKS = TelemetryTx::bitTicks(TELEMETRY_BAUD);
+static_assert((F_CPU / 64) / TELEMETRY_BIT_TICKS * 100 > TELEMETRY_BAUD * 98 &&
+              (F_CPU / 64) / TELEMETRY_BIT_TICKS * 100 < TELEMETRY_BAUD * 102,
+              "TELEMETRY_BAUD is more than 2% off at this clock");
+static_assert(TELEMETRY_BIT_TICKS >= 8, "TELEMETRY_BAUD is too fast for the bit ISR");
+
+#if TC_FIXED_POINT
+static_assert(CONTROL_UPDATE_MS == (unsigned long)(PID_DT_S * 1000.0f),
+              "PID_DT_S must match CONTROL_UPDATE_MS");
+#endif
 
 // ---------------- Global State ----------------------------------------------
-float filteredTempF      = 72.0;     // start, or seed it, near room temp
+// The filter and the set-point are seeded from real readings in setup();
+// the values here are only what they hold until then.
+#if TC_COUNT_THRESHOLDS
+uint16_t filteredCounts  = lm19ConstPos(toCF(72.0)); // filtered LM19 (see above)
+TempCF setPointCF        = MID_SET_CF; // Making set-point global
+BandThresholds band;                   // on/set/off in LM19 counts, from setup()
+#elif TC_FIXED_POINT
+TempCF filteredTempCF    = toCF(72.0); // near room temp
+TempCF setPointCF        = MID_SET_CF; // Making set-point global
+#else
+float filteredTempF      = 72.0;     // near room temp
+float setPointF          = 72.0;     // Making set-point global
+#endif
+#if TC_ADC_INTERRUPT
+uint16_t potRaw          = 511;        // newest pot reading off the sampler
+#endif
+#if TC_ADAPTIVE_SAMPLING
+uint8_t sampleShift      = 0;          // LM19 sampled every TEMP_SAMPLE_MS << this
+#endif
+#if TC_ADC_VCC_COMP
+uint16_t vccRefSum       = 0;          // VCC_SAMPLES bandgap sum at power-on, from setup()
+#endif
+#if TC_ALPHA_BETA
+AlphaBetaFilter tempEstimator(AB_ALPHA_Q8, AB_BETA_Q16);   // the filter; reset in setup()
+#endif
 bool  heaterOn           = false;    // current heater state
 bool  inDeadband         = false;    // true if temp is between ON/OFF thresholds
-float setPointF          = 72.0;     // Making set-point global
 
-// ---------------- Timing State ----------------------------------------------
-unsigned long lastTempSampleMs  = 0;
-unsigned long lastControlMs     = 0;
-unsigned long lastLedBlinkMs    = 0;
-bool          ledBlinkState     = false;
+#if TC_ZONES == 2
+// ---------------- Second Zone -----------------------------------------------
+// What ControlZone needs to know about the second zone. It shares the LM19
+// table, filter constant and band width with the first.
+BandThresholds makeBand(TempCF setCF);           // defined under FUNCTIONS
+
+struct ShelfZone {
+  typedef Zone2SsrPin SsrPin;
+  static const uint8_t TEMP_MUX = ZONE2_TEMP_ADC_CH;
+  static const uint8_t ALPHA_Q8 = TEMP_ALPHA_Q8;
+  static BandThresholds makeBand(TempCF setPointCF) { return ::makeBand(setPointCF); }
+};
+ControlZone<ShelfZone> shelfZone;   // seeded in setup()
+#endif
 
 // ---------------- Declare Objects -------------------------------------------
+// The one source of the set-point; setPointCF/setPointF above are only ever
+// written from what it publishes.
+SetpointKnob setpointKnob(potToSetpointCF, SET_STEP_CF, toCF(SET_HYST_F));
+
 StatusLeds statusLeds(
   LED_ABOVE_PIN,
   LED_INBAND_PIN,
   LED_BELOW_PIN,
-  HYST_F,
-  LED_UPDATE_MS
+#if TC_FIXED_POINT
+  HYST_CF
+#else
+  HYST_F
+#endif
 );
 
+#if TC_SENSOR_FAULT
+SensorFault tempFault(LM19_MIN_POS, LM19_MAX_POS, FAULT_STEP_POS,
+                      FAULT_STUCK_SAMPLES, FAULT_CLEAR_SAMPLES);
+#if TC_ZONES == 2
+SensorFault zone2Fault(LM19_MIN_POS, LM19_MAX_POS, FAULT_STEP_POS,   // same curve as the first
+                       FAULT_STUCK_SAMPLES, FAULT_CLEAR_SAMPLES);
+#endif
+#endif
+
+#if TC_CONTROL_PID
+PidController pid(PID_GAINS);   // until setup() loads tuned gains from EEPROM
+#endif
+#if TC_AUTOTUNE
+RelayAutotune autotune(CONTROL_UPDATE_MS);
+#endif
+#if TC_PREDICTIVE_CUTOFF
+OvershootPredictor overshoot;   // until setup() loads learned leads from EEPROM
+#endif
+#if TC_EEPROM_LOG
+EepromLog eepromLog(EE_LOG_START, EE_LOG_END,
+                    LOG_RECORD_MIN * 60000UL / LOG_SAMPLE_MS, LOG_RECORD_MIN);
+#endif
+
+// Whichever proportional output TC_OUTPUT_MODE picked; both take a 0..255
+// duty through setDuty().
+#if TC_OUTPUT_MODE == TC_OUTPUT_TIME_PROPORTIONAL
+TimeProportionalOutput& heaterOutput = timedSsr;
+#elif TC_OUTPUT_MODE == TC_OUTPUT_PHASE_ANGLE
+PhaseAngleOutput& heaterOutput = phaseSsr;
+#endif
+
+// ---------------- Task Table ------------------------------------------------
+// The scheduler runs each task at its interval; see TaskScheduler.h. Keep the
+// TaskId enum in the same order as the table.
+enum TaskId : uint8_t {
+  TASK_SAMPLE_TEMP,
+#if TC_ZONES == 2
+  TASK_SAMPLE_ZONE2,
+#endif
+  TASK_CONTROL,
+#if TC_EEPROM_LOG
+  TASK_LOG,
+#endif
+  TASK_LEDS,
+#if TC_TELEMETRY
+  TASK_TELEMETRY,
+#endif
+  NUM_TASKS };
+
+void taskSampleTemperature(unsigned long now);   // defined under FUNCTIONS
+void taskSampleZone2(unsigned long now);
+void taskUpdateControl(unsigned long now);
+void taskLog(unsigned long now);
+void taskUpdateLeds(unsigned long now);
+void taskTelemetry(unsigned long now);
+
+ScheduledTask tasks[] = {
+  // run                   intervalMs          lastRunMs
+  { taskSampleTemperature, TEMP_SAMPLE_MS,     0 },
+#if TC_ZONES == 2
+  { taskSampleZone2,       TEMP_SAMPLE_MS,     0 },   // half a period behind; see setup()
+#endif
+  { taskUpdateControl,     CONTROL_UPDATE_MS,  0 },
+#if TC_EEPROM_LOG
+  { taskLog,               LOG_SAMPLE_MS,      0 },
+#endif
+  { taskUpdateLeds,        LED_UPDATE_MS,      0 },
+#if TC_TELEMETRY
+  { taskTelemetry,         TELEMETRY_MS,       0 },
+#endif
+};
+static_assert(sizeof(tasks) / sizeof(tasks[0]) == NUM_TASKS,
+              "Task table and TaskId enum are out of step");
+
+#if TC_PROFILE
+// ---------------- Profiler Slots --------------------------------------------
+// What TaskProfiler times; each slot goes out in its own TELEMETRY_PROFILE
+// frame. PROFILE_LOOP is one whole pass of the scheduler, so its max is the
+// worst-case delay before loop() gets round to anything newly due.
+enum ProfileSlot : uint8_t {
+  PROFILE_LOOP,
+  PROFILE_SAMPLE_TEMP,
+  PROFILE_CONTROL,
+  PROFILE_LED_STATE,      // statusLeds working out the region
+  PROFILE_LED_UPDATE,     // statusLeds driving the LEDs
+  PROFILE_LOG,
+  NUM_PROFILE_SLOTS };
+static_assert(NUM_PROFILE_SLOTS <= TaskProfiler::MAX_SLOTS,
+              "More profiler slots than TaskProfiler has room for");
+#endif
+
+TaskScheduler scheduler(tasks, NUM_TASKS);
+IdleSleep     idleSleep;
+
 
 //=============================================================================
 //==== SET-UP SECTION =========================================================
 //     This runs once at ATTiny boot-up. Configure the ATTiny.
 
 void setup() {
+#if TC_WATCHDOG
+  MCUSR = 0;                // a watchdog reset leaves it running at 15 ms; stop it first
+  wdt_disable();
+#endif
   pinMode(SSR_PIN, OUTPUT);
-  digitalWrite(SSR_PIN, LOW);
+  writeSsr(false);
+#if TC_OUTPUT_MODE == TC_OUTPUT_TIME_PROPORTIONAL
+  timedSsr.begin(SSR_PIN, SSR_WINDOW_MS);   // from here on Timer1 owns the SSR
+#if TC_ADC_BLANKING
+  timedSsr.setEdgeHook(ssrEdge);
+#endif
+#elif TC_OUTPUT_MODE == TC_OUTPUT_PHASE_ANGLE
+  phaseSsr.begin(SSR_PIN, ZC_PIN);          // from here on Timer1 owns the SSR
+#endif
+
+#if TC_TELEMETRY
+  telemetryTx.begin(TELEMETRY_PIN, TELEMETRY_BIT_TICKS);
+#endif
 
-  analogReference(DEFAULT); // Vcc as ADC reference
+  analogReference(DEFAULT); // Vcc as ADC reference (the LM19 may have its own; see TEMP_ADC_CH)
+  seedReadings();           // real temperature and set-point, before the sampler takes the ADC
+#if TC_ADC_INTERRUPT
+  adcSampler.begin(TEMP_ADC_CH, POT_ADC_CH, ADC_BLOCK_SAMPLES, !TC_ADC_NOISE_SLEEP);
+#endif
 
+#if TC_FAST_PINS
+  statusLeds.setLedWriter(LedPins::write);
+#endif
   statusLeds.begin();       // Using StatusLeds object, configure chip to use it
-  statusLeds.selfTest();    // Show user all LEDs are working
+#if TC_COUNT_THRESHOLDS
+  statusLeds.setBand(band); // band edges for the boot-time set-point
+  statusLeds.setCounts(filteredCounts);
+#elif TC_FIXED_POINT
+  statusLeds.setSetPoint(setPointCF);
+  statusLeds.setTemperature(filteredTempCF);
+#else
+  statusLeds.setDisplayState(filteredTempF, setPointF);
+#endif
+  statusLeds.startSelfTest(); // Show user all LEDs are working; the LED task plays it out
+#if TC_SENSOR_FAULT
+  showSensorFault();        // an LM19 already broken at power-on (see seedReadings())
+#endif
+
+#if TC_CONTROL_PID
+  PidGains gains;
+  if (eepromLoadRecord(EE_PID_GAINS_ADDR, EE_TAG_PID_GAINS, &gains, sizeof(gains))) {
+    pid.setGains(gains);    // tuned by an earlier autotune run
+  }
+#endif
+#if TC_PREDICTIVE_CUTOFF
+  OvershootLeads leads;
+  if (eepromLoadRecord(EE_LEADS_ADDR, EE_TAG_LEADS, &leads, sizeof(leads))) {
+    overshoot.setLeads(leads);   // learned before the last power-down
+  }
+#endif
+#if TC_EEPROM_LOG
+  eepromLog.begin();        // find where the history left off
+#endif
+#if TC_AUTOTUNE
+  // Pot fully up at power-on asks for an autotune. Turn it back to the
+  // working set-point straight away; the run restarts on a change anyway.
+  if (readPotRaw() >= AUTOTUNE_POT_MIN) {
+    autotune.start();
+  }
+#endif
+
+#if TC_PROFILE
+  profiler.begin();         // after the outputs, so it knows if Timer1 is free
+#endif
+  scheduler.runSoon(TASK_CONTROL);   // the readings are real already; don't wait a whole interval
+  idleSleep.begin();        // start the awake/asleep bookkeeping from here
+#if TC_ZONES == 2
+  // Take turns with the first zone's LM19, rather than both waiting on
+  // the ADC at once
+  scheduler.runAfter(TASK_SAMPLE_ZONE2, idleSleep.now(), TEMP_SAMPLE_MS / 2);
+#endif
+#if TC_WATCHDOG
+  wdt_enable(WATCHDOG_TIMEOUT);   // from here on loop() has to keep coming round
+#endif
 }
 
 //=============================================================================
 //==== APPLICATION MAIN LOOP ==================================================
 
 void loop() {
-  unsigned long now = millis();
-
-  taskSampleTemperature(now);
-  taskUpdateControl(now);
-  statusLeds.setDisplayState(filteredTempF, setPointF);
-  statusLeds.updateLEDs(now);
+#if TC_WATCHDOG
+  wdt_reset();
+#endif
+  unsigned long idleMs;
+  TC_PROFILE_CALL(PROFILE_LOOP, idleMs = scheduler.runDue(idleSleep.now()));
+  idleSleep.idle(idleMs);   // sleep until the next task is due
 }
 
 
@@ -104,46 +621,222 @@ void loop() {
 //==== FUNCTIONS ==============================================================
 
 /******************************************************************************
- PURPOSE: Read LM19 and return °C
+ PURPOSE: Seed the temperature filter and the set-point from real readings,
+  so control is right from its first run instead of working from 72 °F
+  while the EMA catches up.
 
- NOTES: 
-  - We take an average from multiple readings of the sensor in order to
-    minimize noise. 
-  - We are also guarding against extreme edge cases by testing for, and 
-    setting, min/max possible values.
-  - The formula: tC = (LM19_V0C - v) / LM19_SLOPE is what converts the 
-    read ADC value read from the LM19, at the ATTiny pin it is connected to,
-    into a temperature value. This formula was derived by ChatGPT from the
-    LM19 datasheet, which contains a temperature to Vout table and graph.
-    ChatGPT also claims that the values for V0C and the Slope are values that
-    are commonly seen in application notes and example code across the
-    internet.
+ NOTES:
+  - Called from setup() before adcSampler.begin(), so plain analogRead()
+    still owns the ADC whichever sampling options are built in. The
+    TEMP_SEED_BURSTS * N_SAMPLES LM19 readings take about a millisecond.
+  - The seed goes straight into the filter, with no EMA step, and the band
+    (or the LED band edges) is built for the pot as it is now.
+  - TC_SENSOR_FAULT: the seeds are the detectors' first readings too, so
+    an LM19 that is broken at power-on is known about before control first
+    runs.
+  - TC_ADC_VCC_COMP: the supply as it is now, heater off, is what every
+    later sample is corrected back to (see vccCorrected()).
 *******************************************************************************/
-float readTemperatureC() {
-  const uint8_t N_SAMPLES = 8;
-  uint32_t sum = 0;
+void seedReadings() {
+#if TC_ADC_INTERRUPT
+  potRaw = analogRead(POT_PIN);   // readPotRaw() has no blocks to hand yet
+#endif
 
-  for (uint8_t i = 0; i < N_SAMPLES; i++) {
-    sum += analogRead(TEMP_PIN);
+#if TC_ADC_VCC_COMP
+  uint32_t bandgap = 0;
+  for (uint8_t i = 0; i < TEMP_SEED_BURSTS; i++) {
+    bandgap += adcSampler.sampleInSleep(AdcSampler::MUX_BANDGAP, VCC_SAMPLES);
   }
+  vccRefSum = (uint16_t)(bandgap / TEMP_SEED_BURSTS);
+#endif
 
-  float raw = sum / (float)N_SAMPLES;
-  float v = (raw * VREF) / 1023.0;
+#if TC_FIXED_POINT
+  uint16_t pos = TempSensor::readPos(TEMP_SEED_BURSTS);
+  restartFilter(pos);
+#if TC_SENSOR_FAULT
+  tempFault.begin(pos);
+#endif
+#endif
 
-  // Clamp to sane LM19 range
-  if (v < 0.2) v = 0.2;
-  if (v > 2.8) v = 2.8;
+  setpointKnob.begin(readPotRaw());
+#if TC_COUNT_THRESHOLDS
+  setPointCF     = setpointKnob.setPointCF();
+  band           = makeBand(setPointCF);
+#if TC_ZONES == 2
+  uint16_t pos2  = Zone2Sensor::readPos(TEMP_SEED_BURSTS);
+  shelfZone.begin(pos2, setPointCF + ZONE2_OFFSET_CF);
+#if TC_SENSOR_FAULT
+  zone2Fault.begin(pos2);
+#endif
+#endif
+#elif TC_FIXED_POINT
+  setPointCF     = setpointKnob.setPointCF();
+#else
+  float sum = 0.0f;
+  for (uint8_t i = 0; i < TEMP_SEED_BURSTS; i++) {
+    sum += TempSensor::readF();
+  }
+  filteredTempF = sum / TEMP_SEED_BURSTS;
+  setPointF     = setpointKnob.setPointCF() / 100.0f;
+#endif
+}
 
-  float tC = (LM19_V0C - v) / LM19_SLOPE;
-  return tC;
+#if TC_FIXED_POINT
+/******************************************************************************
+ PURPOSE: Read the LM19 and hand back a table position (see the Fixed-Point
+  Constants): the sum of N_SAMPLES readings, with LM19_SUM_FRAC fraction bits.
+
+ NOTES:
+  - Returns false when there is no new reading yet; the caller should leave
+    its filter alone in that case.
+  - With TC_ADC_INTERRUPT the ISR has already been collecting readings in
+    the background. We take every block it has buffered since last time and
+    scale the total back to an N_SAMPLES sum, so the oversampling is free.
+    Only right after boot (before the first block is done) is there nothing
+    to return.
+  - With TC_ADC_DECIMATE we collect blocks until there are exactly
+    4^TEMP_DECIMATE_BITS readings, then shift the total down by
+    TEMP_DECIMATE_BITS: a reading with that many more bits than the ADC's
+    ten, kept below the sum's own fraction bits. Averaging reading noise
+    away like this is what lets a narrower HYST_F hold without the SSR
+    chattering. It takes 2 * 4^n Timer0 ticks to gather a sample (the pot
+    has every other block), ~1 s for n = 4, so the filter updates at that
+    pace rather than every TEMP_SAMPLE_MS.
+  - With TC_ADC_NOISE_SLEEP we sleep through TEMP_SLEEP_SAMPLES conversions
+    instead. They are quiet enough that we need fewer of them, and the sum
+    is scaled up to the N_SAMPLES sum everything else expects.
+  - Without any of them we just do the original blocking analogRead() loop,
+    in TempSensor.
+*******************************************************************************/
+bool readTemperaturePos(uint16_t& pos) {
+#if TC_ADC_NOISE_SLEEP
+  pos = readLm19PosInSleep(TEMP_ADC_CH);
+  return true;
+#elif TC_ADC_DECIMATE
+  constexpr uint16_t DECIMATE_SAMPLES = 1U << (2 * TEMP_DECIMATE_BITS);
+  constexpr uint16_t POS_PER_DECIMATED = ((uint16_t)N_SAMPLES << LM19_SUM_FRAC) >> TEMP_DECIMATE_BITS;
+  static_assert(DECIMATE_SAMPLES % ADC_BLOCK_SAMPLES == 0,
+                "4^TEMP_DECIMATE_BITS must be a whole number of ADC blocks");
+  static_assert(POS_PER_DECIMATED << TEMP_DECIMATE_BITS == (uint16_t)N_SAMPLES << LM19_SUM_FRAC,
+                "TEMP_DECIMATE_BITS is more bits than a table position has");
+
+  static uint32_t total = 0;      // readings so far towards the next sample
+  static uint16_t samples = 0;
+  uint16_t blockSum;
+
+  while (samples < DECIMATE_SAMPLES && adcSampler.popBlock(AdcSampler::Temp, blockSum)) {
+    total += blockSum;
+    samples += ADC_BLOCK_SAMPLES;
+  }
+  if (samples < DECIMATE_SAMPLES) return false;
+
+  uint16_t decimated = (uint16_t)(total >> TEMP_DECIMATE_BITS);   // 10 + n bits
+  pos = decimated * POS_PER_DECIMATED;
+  total   = 0;
+  samples = 0;
+  return true;
+#elif TC_ADC_INTERRUPT
+  uint32_t total = 0;
+  uint8_t blocks = adcSampler.drain(AdcSampler::Temp, total);
+  if (blocks == 0) return false;
+
+  // Shift before dividing, so the oversampling lands in the fraction bits.
+  uint16_t den = (uint16_t)blocks * ADC_BLOCK_SAMPLES;
+  pos = (uint16_t)((((uint32_t)total * N_SAMPLES << LM19_SUM_FRAC) + den / 2) / den);
+  return true;
+#else
+  pos = TempSensor::readPos();
+  return true;
+#endif
 }
 
-// Celsius → Fahrenheit
-float readTemperatureFOnce() {
-  float c = readTemperatureC();
-  return c * 9.0 / 5.0 + 32.0;
+#if TC_ADC_NOISE_SLEEP
+/******************************************************************************
+ PURPOSE: Read an LM19 there and then in ADC Noise Reduction sleep, on ADC
+  channel mux, as a table position.
+
+ NOTES:
+  - TC_ADC_VCC_COMP: corrected for the supply (see vccCorrected()).
+*******************************************************************************/
+uint16_t readLm19PosInSleep(uint8_t mux) {
+  uint32_t sum = adcSampler.sampleInSleep(mux, TEMP_SLEEP_SAMPLES);
+  uint16_t pos = (uint16_t)(((sum * N_SAMPLES << LM19_SUM_FRAC) + TEMP_SLEEP_SAMPLES / 2) /
+                            TEMP_SLEEP_SAMPLES);
+#if TC_ADC_VCC_COMP
+  pos = vccCorrected(pos);
+#endif
+  return pos;
 }
+#endif
 
+#if TC_ADC_VCC_COMP
+/******************************************************************************
+ PURPOSE: Scale an LM19 position read against Vcc back to the Vcc there was
+  at power-on.
+
+ NOTES:
+  - The bandgap read against Vcc is 1.1 V * 1024 / Vcc, so it rises just as
+    the LM19 reading does when Vcc droops: pos * vccRefSum / bandgap undoes
+    it. Only the ratio to power-on matters, so the bandgap's part-to-part
+    spread cancels out.
+  - Read straight after the LM19's, in the same sleep, VCC_SAMPLES readings
+    (under a millisecond). The result goes through the same filter as the
+    reading, so its own noise is smoothed with it.
+*******************************************************************************/
+uint16_t vccCorrected(uint16_t pos) {
+  uint16_t bandgap = adcSampler.sampleInSleep(AdcSampler::MUX_BANDGAP, VCC_SAMPLES);
+  if (bandgap == 0) return pos;   // can't be; Vcc would be past 1023 * 1.1 V
+
+  uint32_t corrected = (uint32_t)pos * vccRefSum / bandgap;
+  return corrected > 0xFFFF ? 0xFFFF : (uint16_t)corrected;
+}
+#endif
+#endif
+
+/******************************************************************************
+ PURPOSE: Read the pot wiper, 0..1023.
+
+ NOTES:
+  - With TC_ADC_INTERRUPT this is the newest block the sampler has buffered.
+    If none has arrived since last time, the previous reading is reused;
+    until the first one lands, that is the one seedReadings() took.
+*******************************************************************************/
+uint16_t readPotRaw() {
+#if TC_ADC_INTERRUPT
+  uint16_t blockSum;
+
+  while (adcSampler.popBlock(AdcSampler::Pot, blockSum)) {
+    potRaw = blockSum / ADC_BLOCK_SAMPLES;
+  }
+  return potRaw;
+#else
+  return analogRead(POT_PIN);
+#endif
+}
+
+#if TC_FIXED_POINT
+#if TC_COUNT_THRESHOLDS
+/******************************************************************************
+ PURPOSE: Convert a filtered LM19 reading back to hundredths of a °F.
+
+ NOTES:
+  - Neither the control nor the LEDs need this; it's for anything that
+    wants to report the temperature.
+*******************************************************************************/
+TempCF countsToCF(uint16_t counts) {
+  return TempSensor::posToCF(counts);
+}
+
+/******************************************************************************
+ PURPOSE: The band's on/set/off thresholds, as filtered LM19 readings, for
+  a set-point (see bandFor() in ControlMath.h).
+*******************************************************************************/
+BandThresholds makeBand(TempCF setCF) {
+  return bandFor<TempSensor>(setCF);
+}
+#endif
+
+#else
 /******************************************************************************
  PURPOSE: Read the position of the potentiometer and use that to establish
   the user's desired temperature set-point.
@@ -151,31 +844,19 @@ float readTemperatureFOnce() {
  NOTES:
   - Global constants are used to establish the range of temperatures the pot
     can span; as well as the temperature set-point that we want the midpoint
-    of the pot to represent.
-  - We are doing some work here to make sure the pot positions are responsive
-    to our desired range and midpoint.
+    of the pot to represent. See potToSetpointCF() for the mapping.
+  - setpointKnob holds the set-point against pot jitter and to SET_STEP_F
+    steps. setPointF is updated whenever it moves, so the LEDs and the
+    control always see the same set-point (before, setPointF was only
+    updated in the top half of the pot's travel).
 *******************************************************************************/
 float readSetpointF() {
-  uint16_t rawADC = analogRead(POT_PIN);
-  float raw = rawADC;             // convert ADC to float for math to follow
-
-  const float MID_RAW = 511.5f;   // center of the 0–1023 value ADC pins return
-
-  if (raw <= MID_RAW) {
-    // Values: [0 .. MID_RAW] map to range: [MIN_SET_F .. MID_SET_F]
-    float spanRaw  = MID_RAW - 0.0f;          // ≈ 511.5
-    float spanTemp = MID_SET_F - MIN_SET_F;   // ex: 72 - 50 = 22°F
-    float frac = (spanRaw > 0.0f) ? (raw / spanRaw) : 0.0f;
-    return MIN_SET_F + spanTemp * frac;
-  } else {
-    // Values: [MID_RAW .. 1023] map to range: [MID_SET_F .. MAX_SET_F]
-    float spanRaw  = 1023.0f - MID_RAW;       // ≈ 511.5
-    float spanTemp = MAX_SET_F - MID_SET_F;   // ex: 90 - 72 = 18°F
-    float frac = (spanRaw > 0.0f) ? ((raw - MID_RAW) / spanRaw) : 0.0f;
-    setPointF = MID_SET_F + spanTemp * frac;  // setPointF is a global state variable
-    return setPointF;
+  if (setpointKnob.update(readPotRaw())) {
+    setPointF = setpointKnob.setPointCF() / 100.0f;
   }
+  return setPointF;
 }
+#endif
 
 /******************************************************************************
  PURPOSE: Sample temperature periodically and update filteredTempF
@@ -185,42 +866,420 @@ float readSetpointF() {
     the LM19 after being run through an exponential moving average (EMA) to 
     remove jitter and stabilize the control loop. It is dynamic. 
     It changes continuously as the room or enclosure changes temperature.
-  - Our mini-RTS: We continuously call this funtion in the main loop; but it
-    only actually execute at a tempo that is given by the sampling rate
-    (in milliseconds) that we have set in the global constant for that.
+  - Our mini-RTS: The scheduler calls this funtion at the tempo given by the
+    sampling rate (in milliseconds) that we have set in the global constant
+    for that; see the Task Table.
+  - Fixed-point build: the EMA is done in filterReading().
+  - TC_ADAPTIVE_SAMPLING: alpha follows the sample interval, and each new
+    value decides the interval to the next sample.
+  - TC_ALPHA_BETA: tempEstimator takes the place of the EMA; see
+    filterReading().
+  - Each new filtered value is handed to statusLeds here, which is the only
+    time the LED region can change because of the temperature.
+  - TC_SENSOR_FAULT: the raw reading is checked before anything else sees
+    it (see checkSensor()). A bad one shuts the heater off right here and
+    goes no further, so neither the filter nor control ever gets it.
 *******************************************************************************/
 void taskSampleTemperature(unsigned long now) {
-  if (now - lastTempSampleMs < TEMP_SAMPLE_MS) {
-    return;
+  TC_PROFILE_SPAN(PROFILE_SAMPLE_TEMP);
+
+#if TC_FIXED_POINT
+  uint16_t pos;
+  if (!readTemperaturePos(pos)) {
+    return;   // sampler has nothing new yet
+  }
+#if TC_SENSOR_FAULT
+  if (!checkSensor(pos)) {
+    return;   // heater held off until the readings are good again
   }
-  lastTempSampleMs = now;
+#endif
+  pos = TempSensor::clampPos(pos);
+#endif
 
-  float tempFraw = readTemperatureFOnce();
+#if TC_COUNT_THRESHOLDS
+  uint16_t countsRaw = pos;
+  uint16_t last      = filteredCounts;
+
+  filteredCounts = (uint16_t)constrain(filterReading(last, countsRaw),
+                                       (int32_t)LM19_MIN_POS, (int32_t)LM19_MAX_POS);
+  TC_PROFILE_CALL(PROFILE_LED_STATE, statusLeds.setCounts(filteredCounts));
+#if TC_ADAPTIVE_SAMPLING
+  adaptSampleInterval(filteredCounts, filterChange(last, filteredCounts),
+                      band.offCounts, band.onCounts);
+#endif
+#elif TC_FIXED_POINT
+  TempCF tempCFraw = TempSensor::posToCF(pos);
+  TempCF last      = filteredTempCF;
+
+  filteredTempCF = (TempCF)filterReading(last, tempCFraw);
+  TC_PROFILE_CALL(PROFILE_LED_STATE, statusLeds.setTemperature(filteredTempCF));
+#if TC_ADAPTIVE_SAMPLING
+  adaptSampleInterval(filteredTempCF, filterChange(last, filteredTempCF),
+                      setPointCF + HALF_BAND_CF, setPointCF - HALF_BAND_CF);
+#endif
+#else
+  float tempFraw = TempSensor::readF();
 
   // Exponential moving average
   filteredTempF = filteredTempF * (1.0f - TEMP_ALPHA) + tempFraw * TEMP_ALPHA;
+  TC_PROFILE_CALL(PROFILE_LED_STATE, statusLeds.setDisplayState(filteredTempF, setPointF));
+#endif
+}
+
+#if TC_ZONES == 2
+/******************************************************************************
+ PURPOSE: Sample the second zone's LM19 into its filter.
+
+ NOTES:
+  - Runs at TEMP_SAMPLE_MS like the first zone's task, but half a period
+    behind it (setup() sees to that), so the two take turns at the ADC.
+  - Always at the full rate and through the plain EMA; the sampling and
+    filter options are for the first zone.
+  - TC_SENSOR_FAULT: checked like the first zone's, by its own detector, and
+    a fault shuts off only this zone's heater. The fault pattern on the
+    LEDs stands for either zone.
+*******************************************************************************/
+void taskSampleZone2(unsigned long now) {
+#if TC_ADC_NOISE_SLEEP
+  uint16_t pos = readLm19PosInSleep(ShelfZone::TEMP_MUX);
+#else
+  uint16_t pos = Zone2Sensor::readPos();
+#endif
+
+#if TC_SENSOR_FAULT
+  bool wasFaulted = zone2Fault.faulted();
+  if (!zone2Fault.check(pos, shelfZone.heaterOn())) {
+    if (!wasFaulted) {
+      shelfZone.shutOff();
+      showSensorFault();
+    }
+    return;
+  }
+  if (wasFaulted) {
+    shelfZone.begin(pos, shelfZone.setPointCF());   // the filter is from before the fault
+    showSensorFault();
+    return;
+  }
+#endif
+  shelfZone.sample(Zone2Sensor::clampPos(pos));
+}
+#endif
+
+#if TC_SENSOR_FAULT
+/******************************************************************************
+ PURPOSE: Run a new raw LM19 reading past tempFault, and act on what it
+  says. Returns whether the reading can be used.
+
+ NOTES:
+  - On a new fault the heater goes off now, from the sampling task, rather
+    than at the next control period: with the EMA in the way that could be
+    several seconds of full power on a reading that means nothing.
+  - Once the readings are good again the filter is restarted from the
+    first of them; what it held is from before the fault. Control picks up
+    again at its next period.
+  - So does the PID, from scratch: its last reading would give a D kick on
+    the first step, and its integral is from before the fault. The
+    time-proportional window starts over with that step's duty too.
+*******************************************************************************/
+bool checkSensor(uint16_t pos) {
+  bool wasFaulted = tempFault.faulted();
+
+  if (!tempFault.check(pos, heatingFull())) {
+    if (!wasFaulted) {
+      sensorFailSafe();
+      showSensorFault();
+    }
+    return false;
+  }
+  if (wasFaulted) {
+    restartFilter(pos);
+#if TC_CONTROL_PID
+    pid.reset();
+#endif
+#if TC_OUTPUT_MODE == TC_OUTPUT_TIME_PROPORTIONAL
+    timedSsr.restartWindow();
+#endif
+    showSensorFault();
+  }
+  return true;
+}
+
+/******************************************************************************
+ PURPOSE: Heater off, at once, whatever the output mode.
+
+ NOTES:
+  - taskUpdateControl() leaves the heater alone while tempFault is set, so
+    it stays off.
+  - TC_PREDICTIVE_CUTOFF: the predictor is told of the switch like any
+    other, so its idea of the heater stays in step with the SSR.
+*******************************************************************************/
+void sensorFailSafe() {
+#if TC_OUTPUT_MODE == TC_OUTPUT_HYSTERESIS
+  writeSsr(false);
+#if TC_PREDICTIVE_CUTOFF
+  if (heaterOn) overshoot.switched(false);
+#endif
+#else
+  heaterOutput.shutOff();
+#endif
+  heaterOn   = false;
+  inDeadband = false;
+}
+
+/******************************************************************************
+ PURPOSE: Flash the fault pattern while either zone has a sensor fault.
+*******************************************************************************/
+void showSensorFault() {
+  statusLeds.setFault(sensorFaulted());
+}
+
+bool sensorFaulted() {
+#if TC_ZONES == 2
+  return tempFault.faulted() || zone2Fault.faulted();
+#else
+  return tempFault.faulted();
+#endif
+}
+
+/******************************************************************************
+ PURPOSE: Is the heater on at full power? What a stuck reading is judged by.
+*******************************************************************************/
+bool heatingFull() {
+#if TC_OUTPUT_MODE != TC_OUTPUT_HYSTERESIS
+  return heaterOutput.duty() == 255;
+#else
+  return heaterOn;
+#endif
+}
+#endif
+
+#if TC_FIXED_POINT
+/******************************************************************************
+ PURPOSE: Start the filter over from one reading (a table position), as if
+  it were the only one there had ever been.
+*******************************************************************************/
+void restartFilter(uint16_t pos) {
+#if TC_ALPHA_BETA && TC_COUNT_THRESHOLDS
+  tempEstimator.reset(pos);
+#elif TC_ALPHA_BETA
+  tempEstimator.reset(TempSensor::posToCF(pos));
+#endif
+#if TC_COUNT_THRESHOLDS
+  filteredCounts = TempSensor::clampPos(pos);
+#else
+  filteredTempCF = TempSensor::posToCF(pos);
+#endif
+}
+#endif
+
+#if TC_FIXED_POINT
+/******************************************************************************
+ PURPOSE: Filter one new LM19 reading, raw, into the last filtered value,
+  and return the new filtered value. Both are in whichever units the build
+  filters in (LM19 table positions or TempCF).
+
+ NOTES:
+  - The EMA is written as f += alpha * (raw - f) with alpha as an 8-bit
+    fraction. The +128 rounds the step to nearest, which keeps the filter
+    from parking up to 0.1 °F short of the true value.
+  - TC_ALPHA_BETA: tempEstimator keeps its own state, which is why it
+    needs no "filtered" from here. It follows a ramp with no lag, where the
+    EMA trails by (1 - TEMP_ALPHA) / TEMP_ALPHA samples (2.25 s at
+    TEMP_SAMPLE_MS), which the heater would otherwise overshoot by.
+*******************************************************************************/
+int32_t filterReading(int32_t filtered, int32_t raw) {
+#if TC_ALPHA_BETA
+  tempEstimator.update(raw, currentSampleShift());
+  return tempEstimator.value();
+#else
+  return emaStepQ8(filtered, raw, emaAlphaQ8());
+#endif
+}
+
+/******************************************************************************
+ PURPOSE: How far the filtered value is moving per sample, given its last
+  two values.
+
+ NOTES:
+  - With TC_ALPHA_BETA this is the estimator's rate instead, which doesn't
+    mistake one noisy step for movement.
+*******************************************************************************/
+int32_t filterChange(int32_t last, int32_t filtered) {
+#if TC_ALPHA_BETA
+  return tempEstimator.change(currentSampleShift());
+#else
+  return filtered - last;
+#endif
 }
 
+/******************************************************************************
+ PURPOSE: The EMA factor for the current sample interval, as an 8-bit
+  fraction.
+*******************************************************************************/
+uint8_t emaAlphaQ8() {
+#if TC_ADAPTIVE_SAMPLING
+  return pgm_read_byte(&TEMP_ALPHA_Q8_AT[sampleShift]);
+#else
+  return TEMP_ALPHA_Q8;
+#endif
+}
+
+/******************************************************************************
+ PURPOSE: Samples come every TEMP_SAMPLE_MS << this.
+*******************************************************************************/
+uint8_t currentSampleShift() {
+#if TC_ADAPTIVE_SAMPLING
+  return sampleShift;
+#else
+  return 0;
+#endif
+}
+#endif
+
+#if TC_ADAPTIVE_SAMPLING
+/******************************************************************************
+ PURPOSE: Pick the interval to the next LM19 sample.
+
+ NOTES:
+  - value is the new filtered reading and change how far it just moved;
+    offEdge and onEdge are the band edges the heater goes off and on at.
+    All are in the units the build filters in (LM19 table positions or
+    TempCF); only distances matter, so it does not care that counts run
+    opposite to temperature.
+  - The distance is to the edge that matters next. With the hysteresis
+    output that is the one the heater is heading for: offEdge while it is
+    on, onEdge while it is off, so a soak inside the band backs off too and
+    only the run-up to a switch is at full rate. A proportional output is
+    working all through the band, so there it is the nearer edge, and 0
+    inside.
+  - Within SAMPLE_NEAR of that edge, or on course to reach it within
+    SAMPLE_MARGIN samples: straight back to every TEMP_SAMPLE_MS.
+  - Otherwise the interval doubles, one step per sample, up to
+    TEMP_SAMPLE_MS << SAMPLE_SLOWEST_SHIFT, as long as the edge would still
+    be SAMPLE_MARGIN of the longer samples away.
+  - "Reaches the edge within n samples" is n * |change| >= distance, so
+    there is no divide.
+*******************************************************************************/
+void adaptSampleInterval(int32_t value, int32_t change, int32_t offEdge, int32_t onEdge) {
+#if TC_OUTPUT_MODE == TC_OUTPUT_HYSTERESIS
+  int32_t edge     = heaterOn ? offEdge : onEdge;
+  int32_t distance = value > edge ? value - edge : edge - value;
+#else
+  int32_t lo = offEdge < onEdge ? offEdge : onEdge;
+  int32_t hi = offEdge < onEdge ? onEdge : offEdge;
+  int32_t distance = value < lo ? lo - value : (value > hi ? value - hi : 0);
+#endif
+  if (change < 0) change = -change;
+
+  uint8_t shift = sampleShift;
+  if (distance <= SAMPLE_NEAR || change * SAMPLE_MARGIN >= distance) {
+    shift = 0;
+  } else if (shift < SAMPLE_SLOWEST_SHIFT && change * (2 * SAMPLE_MARGIN) < distance) {
+    shift++;
+  }
+  setSampleShift(shift);
+}
+
+/******************************************************************************
+ PURPOSE: Sample the LM19 every TEMP_SAMPLE_MS << shift from now on.
+*******************************************************************************/
+void setSampleShift(uint8_t shift) {
+  if (shift == sampleShift) return;
+  sampleShift = shift;
+  scheduler.setInterval(TASK_SAMPLE_TEMP, TEMP_SAMPLE_MS << shift);
+}
+#endif
+
 /******************************************************************************
  PURPOSE: Update heater control based on filtered temp + setpoint
 
  NOTES:
-  - Our mini-RTS: We continuously call this funtion in the main loop; but it
-    only actually execute at a tempo that is given by the sampling rate
-    (in milliseconds) that we have set in the global constant for that.
+  - Our mini-RTS: The scheduler calls this funtion at the tempo given by the
+    control update rate (in milliseconds) that we have set in the global
+    constant for that; see the Task Table.
   - The hysteresis band is the full swing between low and high. So the idea is
     that the set-point is the middle of that band. E.g., if HYST_F = 2.0, and
     the set-point is 70-degrees, then the temp will vary between 69-71.
+  - With a proportional TC_OUTPUT_MODE the same band is a proportional band
+    instead: full on at its low edge, off at its high edge and in between
+    the heater gets the matching fraction of full power (of each window for
+    TC_OUTPUT_TIME_PROPORTIONAL, of each half-cycle for
+    TC_OUTPUT_PHASE_ANGLE). heaterOn then means "some power".
+  - With TC_CONTROL_PID the duty comes from the PID controller instead, and
+    the band only decides what the LEDs show.
+  - While an autotune run is in progress (TC_AUTOTUNE) the heater is driven
+    by the plain hysteresis decision at full power, which is the relay the
+    experiment needs; see RelayAutotune.h.
+  - TC_PREDICTIVE_CUTOFF: the heater goes off early, on where the
+    temperature will coast to, and back on as much late; see
+    predictiveWantOn().
+  - TC_ZONES = 2: the second zone takes its plain on/off decision here too,
+    at the same set-point (plus ZONE2_OFFSET_F).
+  - TC_SENSOR_FAULT: a zone whose LM19 has failed is skipped; the sampling
+    task has already shut its heater off (see checkSensor()). The
+    set-point is still followed.
 *******************************************************************************/
 void taskUpdateControl(unsigned long now) {
-  if (now - lastControlMs < CONTROL_UPDATE_MS) {
-    return;
+  TC_PROFILE_SPAN(PROFILE_CONTROL);
+
+#if TC_FIXED_POINT
+  updateSetPoint();
+#if TC_ZONES == 2
+  bool zone2WasOn = shelfZone.heaterOn();
+#if TC_SENSOR_FAULT
+  if (!zone2Fault.faulted())
+#endif
+  shelfZone.control();      // the second zone is always on/off
+  if (shelfZone.heaterOn() != zone2WasOn) ssrEdge();
+#endif
+#if TC_SENSOR_FAULT
+  if (tempFault.faulted()) return;
+#endif
+
+#if TC_OUTPUT_MODE == TC_OUTPUT_HYSTERESIS
+#if TC_PREDICTIVE_CUTOFF
+  bool wantOn = predictiveWantOn(heaterOn);
+#else
+  bool wantOn = hysteresisWantOn(heaterOn);
+#endif
+
+  // Drive SSR immediately when state changes, and only then
+  if (wantOn != heaterOn) {
+    heaterOn = wantOn;
+    writeSsr(heaterOn);
+#if TC_PREDICTIVE_CUTOFF
+    overshoot.switched(heaterOn);
+#endif
+  }
+#else
+  uint8_t duty;
+#if TC_AUTOTUNE
+  if (autotune.isRunning()) {
+    duty = hysteresisWantOn(heaterOn) ? 255 : 0;
+    if (autotune.update(now, setPointCF, filteredCF(), duty != 0)) {
+      finishAutotune();
+    }
+  } else
+#endif
+  {
+#if TC_CONTROL_PID
+    duty = pid.update(setPointCF, filteredCF());
+#else
+    duty = bandDuty();
+#endif
+    inDeadband = (duty > 0 && duty < 255);
   }
-  lastControlMs = now;
 
+  heaterOn = (duty > 0);
+  if (duty != heaterOutput.duty()) {
+    heaterOutput.setDuty(duty);   // takes effect from the next window/half-cycle
+  }
+#endif
+#else
   float setF = readSetpointF();
   float tempF = filteredTempF;
   const float halfBand = HYST_F * 0.5f;
+  TC_PROFILE_CALL(PROFILE_LED_STATE, statusLeds.setDisplayState(tempF, setPointF));
 
   bool wantOn = heaterOn;  // default: keep current state
   inDeadband = false;
@@ -236,9 +1295,317 @@ void taskUpdateControl(unsigned long now) {
     inDeadband = true;
   }
 
-  heaterOn = wantOn;
+  // Drive SSR immediately when state changes, and only then
+  if (wantOn != heaterOn) {
+    heaterOn = wantOn;
+    writeSsr(heaterOn);
+  }
+#endif
+}
+
+#if TC_FIXED_POINT
+/******************************************************************************
+ PURPOSE: Pick up the pot set-point, and pass it on when it has changed.
+
+ NOTES:
+  - setpointKnob says when the set-point has really moved (see
+    SetpointKnob.h); pot jitter and readings within the same SET_STEP_F step
+    leave everything as it was.
+  - TC_COUNT_THRESHOLDS: only rebuild the thresholds when the set-point has
+    actually moved. After that the hysteresis decision is three integer
+    compares on raw LM19 counts.
+  - TC_ADAPTIVE_SAMPLING: a new set-point moves the band edges, so sampling
+    goes back to full rate until adaptSampleInterval() has had a look.
+*******************************************************************************/
+void updateSetPoint() {
+  if (!setpointKnob.update(readPotRaw())) return;   // no real change
+  setPointCF = setpointKnob.setPointCF();
+#if TC_ZONES == 2
+  shelfZone.setSetPoint(setPointCF + ZONE2_OFFSET_CF);
+#endif
 
-  // Drive SSR immediately when state changes
-  digitalWrite(SSR_PIN, heaterOn ? HIGH : LOW);
+#if TC_COUNT_THRESHOLDS
+  band = makeBand(setPointCF);
+  statusLeds.setBand(band);
+#else
+  statusLeds.setSetPoint(setPointCF);
+#endif
+#if TC_ADAPTIVE_SAMPLING
+  setSampleShift(0);
+#endif
 }
 
+/******************************************************************************
+ PURPOSE: The original on/off decision: should the heater be on, given that
+  it is (isOn) or isn't now? Also sets inDeadband.
+*******************************************************************************/
+bool hysteresisWantOn(bool isOn) {
+  bool wantOn = isOn;  // default: keep current state
+  inDeadband = false;
+
+#if TC_COUNT_THRESHOLDS
+  // Counts fall as temperature rises (see BandThresholds in FixedTemp.h)
+  if (filteredCounts >= band.onCounts) {
+    // Too cold: turn heater on
+    wantOn = true;
+  } else if (filteredCounts <= band.offCounts) {
+    // Too hot: turn heater off
+    wantOn = false;
+  } else {
+    // Between thresholds: deadband
+    inDeadband = true;
+  }
+#else
+  if (filteredTempCF <= setPointCF - HALF_BAND_CF) {
+    // Too cold: turn heater on
+    wantOn = true;
+  } else if (filteredTempCF >= setPointCF + HALF_BAND_CF) {
+    // Too hot: turn heater off
+    wantOn = false;
+  } else {
+    // Between thresholds: deadband
+    inDeadband = true;
+  }
+#endif
+  return wantOn;
+}
+
+#if TC_PREDICTIVE_CUTOFF
+/******************************************************************************
+ PURPOSE: hysteresisWantOn(), but turning the heater off on where the
+  temperature is heading instead of where it is, so less of the coast after
+  switching off lands past the top of the band.
+
+ NOTES:
+  - OvershootPredictor wants a value that rises with temperature, so the
+    count build hands it the counts negated, and the band edges with them.
+  - Only the turn-off is early, and only by half the predicted coast: the
+    heater goes off once the reading plus that half reaches the top edge.
+    The turn-on waits for the reading to be as far below the bottom edge. The
+    half taken off the top of the swing goes back on at the bottom, so the
+    cycle is as long as plain hysteresis and the SSR switches no more
+    often; switching early at both ends narrows the swing, but with on/off
+    control that shortens the cycle to match.
+  - The predicted coast is held to half the band, so the turn-off is never
+    more than a quarter band early: a burst of rate noise can't turn the
+    heater off while the box is still below the set-point.
+  - When a newly measured coast has moved the leads far enough, they are
+    saved. The EEPROM write blocks for up to ~20 ms, a few times while the
+    leads settle and rarely after that.
+*******************************************************************************/
+bool predictiveWantOn(bool isOn) {
+#if TC_COUNT_THRESHOLDS
+  int32_t value = -(int32_t)filteredCounts;
+  int32_t onAt  = -(int32_t)band.onCounts;
+  int32_t offAt = -(int32_t)band.offCounts;
+#else
+  int32_t value = filteredTempCF;
+  int32_t onAt  = setPointCF - HALF_BAND_CF;
+  int32_t offAt = setPointCF + HALF_BAND_CF;
+#endif
+  static int32_t halfCoast = 0;   // half the predicted coast at the last turn-off
+
+  if (overshoot.update(value, isOn)) {
+    eepromSaveRecord(EE_LEADS_ADDR, EE_TAG_LEADS, &overshoot.leads(), sizeof(OvershootLeads));
+    overshoot.markSaved();
+  }
+
+  int32_t halfBand = (offAt - onAt) / 2;
+  int32_t lead     = constrain(overshoot.predicted() - value, 0, halfBand) / 2;
+  bool wantOn = isOn;  // default: keep current state
+  inDeadband = false;
+
+  if (value <= onAt - halfCoast) {
+    // Too cold, by as much as the last turn-off came early: turn heater on
+    wantOn = true;
+  } else if (value + lead >= offAt) {
+    // Will coast too far past the top: turn heater off
+    wantOn = false;
+    if (isOn) halfCoast = lead;
+  } else {
+    // Between thresholds: deadband
+    inDeadband = true;
+  }
+  return wantOn;
+}
+#endif
+
+/******************************************************************************
+ PURPOSE: The filtered temperature in hundredths of a °F, whichever form it
+  is kept in.
+*******************************************************************************/
+TempCF filteredCF() {
+#if TC_COUNT_THRESHOLDS
+  return countsToCF(filteredCounts);
+#else
+  return filteredTempCF;
+#endif
+}
+#endif
+
+#if TC_OUTPUT_MODE != TC_OUTPUT_HYSTERESIS && !TC_CONTROL_PID
+/******************************************************************************
+ PURPOSE: Turn the position in the proportional band into an SSR duty,
+  0..255: full on at the cold edge, off at the hot edge.
+*******************************************************************************/
+uint8_t bandDuty() {
+#if TC_COUNT_THRESHOLDS
+  // Counts fall as temperature rises, so "into the band" is measured up
+  // from the off (hot) edge.
+  int32_t intoBand  = (int32_t)filteredCounts - band.offCounts;
+  int32_t bandWidth = band.onCounts - band.offCounts;
+#else
+  int32_t intoBand  = (int32_t)(setPointCF + HALF_BAND_CF) - filteredTempCF;
+  int32_t bandWidth = 2 * HALF_BAND_CF;
+#endif
+
+  if (intoBand <= 0) return 0;
+  if (intoBand >= bandWidth) return 255;
+  return (uint8_t)(intoBand * 255 / bandWidth);
+}
+#endif
+
+#if TC_AUTOTUNE
+/******************************************************************************
+ PURPOSE: An autotune run has just finished: hand its gains to the PID and
+  keep them in EEPROM for the next boot.
+
+ NOTES:
+  - The PID starts over from zero, rather than from an integral built up
+    under the old gains. The EEPROM write blocks for a few tens of ms, once.
+*******************************************************************************/
+void finishAutotune() {
+  pid.setGains(autotune.gains());
+  pid.reset();
+  eepromSaveRecord(EE_PID_GAINS_ADDR, EE_TAG_PID_GAINS, &autotune.gains(), sizeof(PidGains));
+}
+#endif
+
+#if TC_EEPROM_LOG
+/******************************************************************************
+ PURPOSE: Add the current state to the history log, and let the log write
+  out a byte if it has a batch waiting.
+
+ NOTES:
+  - Sits right after the control task in the table, so it sees this
+    period's decision.
+  - With on/off control the duty is 0 or 255 each sample, so the record's
+    average is the heater's on-time fraction.
+*******************************************************************************/
+void taskLog(unsigned long now) {
+  TC_PROFILE_SPAN(PROFILE_LOG);
+
+#if TC_OUTPUT_MODE != TC_OUTPUT_HYSTERESIS
+  uint8_t duty = heaterOutput.duty();
+#else
+  uint8_t duty = heaterOn ? 255 : 0;
+#endif
+  eepromLog.sample(filteredCF(), setPointCF, duty);
+  eepromLog.service();
+}
+#endif
+
+/******************************************************************************
+ PURPOSE: Switch the SSR (and so the heater) on or off.
+*******************************************************************************/
+void writeSsr(bool on) {
+#if TC_FAST_PINS
+  SsrPin::write(on);
+#else
+  digitalWrite(SSR_PIN, on ? HIGH : LOW);
+#endif
+  ssrEdge();
+}
+
+/******************************************************************************
+ PURPOSE: An SSR has just switched (or been told to). With TC_ADC_BLANKING
+  the ADC keeps off the supply for SSR_BLANK_MS while it settles from the
+  step in load; see AdcSampler::blank().
+
+ NOTES:
+  - Also TimeProportionalOutput's edge hook, so it may be called from its
+    ISR.
+*******************************************************************************/
+void ssrEdge() {
+#if TC_ADC_BLANKING
+  adcSampler.blank(SSR_BLANK_MS);
+#endif
+}
+
+/******************************************************************************
+ PURPOSE: Scheduled task wrapper so the status LEDs can sit in the task table.
+
+ NOTES:
+  - TC_ADC_BLANKING: a change of LEDs blanks the ADC for LED_BLANK_MS, as an
+    SSR edge does.
+*******************************************************************************/
+void taskUpdateLeds(unsigned long now) {
+  bool changed;
+  TC_PROFILE_CALL(PROFILE_LED_UPDATE, changed = statusLeds.updateLEDs());
+#if TC_ADC_BLANKING
+  if (changed) adcSampler.blank(LED_BLANK_MS);
+#else
+  (void)changed;
+#endif
+}
+
+#if TC_TELEMETRY
+/******************************************************************************
+ PURPOSE: Send one TELEMETRY_STATUS frame (see TelemetryTx.h).
+
+ NOTES:
+  - If the previous frame is somehow still going out this one is simply
+    skipped; nothing here ever waits on the serial line.
+*******************************************************************************/
+void taskTelemetry(unsigned long now) {
+  TelemetryStatus status;
+
+  status.tempCF     = filteredCF();
+  status.setPointCF = setPointCF;
+  status.flags      = (heaterOn ? 0x01 : 0) | (inDeadband ? 0x02 : 0) |
+                      (uint8_t)(statusLeds.region() << 4);
+#if TC_SENSOR_FAULT
+  if (sensorFaulted()) status.flags |= 0x04;
+#endif
+#if TC_OUTPUT_MODE != TC_OUTPUT_HYSTERESIS
+  status.duty       = heaterOutput.duty();
+#else
+  status.duty       = heaterOn ? 255 : 0;
+#endif
+  status.awakePermille = idleSleep.dutyPermille();
+
+  telemetryTx.sendFrame(TELEMETRY_STATUS, &status, sizeof(status));
+#if TC_PROFILE
+  sendProfileFrame();
+#endif
+}
+#endif
+
+#if TC_PROFILE
+/******************************************************************************
+ PURPOSE: Send the next profiler slot as a TELEMETRY_PROFILE frame and start
+  its next window.
+
+ NOTES:
+  - One slot per telemetry period, round robin, so each slot's figures
+    cover NUM_PROFILE_SLOTS periods.
+  - If the frame doesn't fit in the TX buffer the slot keeps counting and
+    goes next time.
+*******************************************************************************/
+void sendProfileFrame() {
+  static uint8_t slot = 0;
+  const ProfileStats& stats = profiler.stats(slot);
+  TelemetryProfile frame;
+
+  frame.slot        = slot;
+  frame.count       = stats.count;
+  frame.minCycles   = stats.count ? stats.minCycles : 0;
+  frame.maxCycles   = stats.maxCycles;
+  frame.totalCycles = stats.totalCycles;
+
+  if (telemetryTx.sendFrame(TELEMETRY_PROFILE, &frame, sizeof(frame))) {
+    profiler.reset(slot);
+    slot = (slot + 1) % NUM_PROFILE_SLOTS;
+  }
+}
+#endif
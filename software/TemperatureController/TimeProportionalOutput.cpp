@@ -0,0 +1,147 @@
+#include "BuildOptions.h"
+#include "TimeProportionalOutput.h"
+
+// Only build this (and claim the Timer1 compare vector) when it is used.
+#if TC_OUTPUT_MODE == TC_OUTPUT_TIME_PROPORTIONAL
+
+TimeProportionalOutput timedSsr;
+
+// Timer1 in CTC mode, /64 prescaler: one compare match every TICK_MS
+static const uint16_t TICK_OCR = (uint16_t)(F_CPU / 64UL * TimeProportionalOutput::TICK_MS / 1000UL - 1);
+
+/******************************************************************************
+ DESCRIPTION: Constructor, using initializer list. Nothing touches the
+  hardware until begin().
+*******************************************************************************/
+TimeProportionalOutput::TimeProportionalOutput()
+      :
+      _port(0),
+      _mask(0),
+      _windowTicks(1),
+      _tick(0),
+      _onTicks(0),
+      _nextOnTicks(0),
+      _duty(0),
+      _restartWindow(false),
+      _edgeHook(0)
+      {}
+
+/******************************************************************************
+ DESCRIPTION: Take over the SSR pin and start the Timer1 tick.
+
+ NOTES:
+  - pin is an Arduino pin number; it must already be an OUTPUT.
+  - The pin's port register and bit are looked up once, here, so the ISR can
+    switch it with a single masked write.
+  - The output starts off (duty 0).
+*******************************************************************************/
+void TimeProportionalOutput::begin(uint8_t pin, uint16_t windowMs) {
+  _port        = portOutputRegister(digitalPinToPort(pin));
+  _mask        = digitalPinToBitMask(pin);
+  _windowTicks = windowMs / TICK_MS;
+  if (_windowTicks == 0) _windowTicks = 1;
+  _tick        = 0;
+  _onTicks     = 0;
+  _nextOnTicks = 0;
+  _duty        = 0;
+  _restartWindow = false;
+
+  TCCR1A = 0;
+  TCCR1B = _BV(WGM12) | _BV(CS11) | _BV(CS10);   // CTC on OCR1A, clk/64
+  TCNT1  = 0;
+  OCR1A  = TICK_OCR;
+  TIMSK1 |= _BV(OCIE1A);
+}
+
+/******************************************************************************
+ DESCRIPTION: Set the on-fraction for the coming windows, 0..255.
+*******************************************************************************/
+void TimeProportionalOutput::setDuty(uint8_t duty) {
+  _duty = duty;
+  uint16_t onTicks = (uint16_t)(((uint32_t)duty * _windowTicks + 127) / 255);
+
+  uint8_t sreg = SREG;    // 16-bit value shared with the ISR
+  cli();
+  _nextOnTicks = onTicks;
+  if (_restartWindow) {
+    _tick = 0;            // latched on the very next tick
+    _restartWindow = false;
+  }
+  SREG = sreg;
+}
+
+/******************************************************************************
+ DESCRIPTION: Duty 0, and the SSR off now rather than at the end of the
+  window (e.g. the sensor has failed).
+*******************************************************************************/
+void TimeProportionalOutput::shutOff() {
+  setDuty(0);
+
+  uint8_t sreg = SREG;    // the ISR must not switch it back on
+  cli();
+  _onTicks = 0;
+  *_port &= (uint8_t)~_mask;
+  SREG = sreg;
+}
+
+/******************************************************************************
+ DESCRIPTION: Have the next setDuty() start a window of its own at once,
+  rather than wait out what is left of this one (e.g. control is taking
+  over again after shutOff()).
+*******************************************************************************/
+void TimeProportionalOutput::restartWindow() {
+  _restartWindow = true;
+}
+
+/******************************************************************************
+ DESCRIPTION: Call hook from the ISR on every SSR edge from now on; 0 for
+  none.
+*******************************************************************************/
+void TimeProportionalOutput::setEdgeHook(EdgeHook hook) {
+  uint8_t sreg = SREG;    // the ISR may be about to call the old one
+  cli();
+  _edgeHook = hook;
+  SREG = sreg;
+}
+
+/******************************************************************************
+ DESCRIPTION: Timer1 tick handler. Switches the SSR on at the start of the
+  window (if there is any on-time) and off once the on-time has run out.
+*******************************************************************************/
+void TimeProportionalOutput::onTick() {
+  uint16_t tick = _tick;
+
+  if (tick == 0) {
+    _onTicks = _nextOnTicks;
+  }
+
+  bool on = tick < _onTicks;
+  if (on != ((*_port & _mask) != 0)) {
+    if (on) {
+      *_port |= _mask;
+    } else {
+      *_port &= (uint8_t)~_mask;
+    }
+    if (_edgeHook) _edgeHook();
+  }
+
+  if (++tick >= _windowTicks) tick = 0;
+  _tick = tick;
+}
+
+/******************************************************************************
+ DESCRIPTION: Getter methods
+*******************************************************************************/
+uint8_t TimeProportionalOutput::duty() const {
+  return _duty;
+}
+
+bool TimeProportionalOutput::isOn() const {
+  return (*_port & _mask) != 0;
+}
+
+ISR(TIM1_COMPA_vect) {
+  timedSsr.onTick();
+}
+
+#endif // TC_OUTPUT_MODE == TC_OUTPUT_TIME_PROPORTIONAL
@@ -0,0 +1,64 @@
+#ifndef TIME_PROPORTIONAL_OUTPUT_H
+#define TIME_PROPORTIONAL_OUTPUT_H
+
+#include <Arduino.h>
+
+/******************************************************************************
+ DESCRIPTION: This class is part of the Temperature Controller application.
+  It drives the SSR in "time-proportioning" (slow PWM) mode: within each
+  fixed window of a few seconds the SSR is on for a fraction of the window
+  set by the controller, and off for the rest.
+
+ NOTES:
+  - The timing runs entirely off a Timer1 compare interrupt every 10 ms, so
+    the SSR edges don't move around with how busy loop() is. 10 ms is also
+    about one mains half-cycle, which is as fine as a zero-cross SSR can
+    switch anyway.
+  - Duty is 0..255 (255 = on for the whole window). A new duty takes effect
+    at the start of the next window, so one window never gets two pulses.
+    shutOff() is the exception: off at once, for when it can't wait.
+    restartWindow() is the way back: the next duty starts a window of its
+    own at once.
+  - setEdgeHook() hands in a function to call, from the ISR, each time the
+    SSR switches (e.g. to blank the ADC while the supply settles). Keep it
+    short.
+  - Timer1 is not available for anything else (e.g. analogWrite() on PA5/
+    PA6) while this is in use. It also stops in power-down sleep.
+  - There is only one Timer1, so there is exactly one instance: timedSsr.
+*******************************************************************************/
+
+class TimeProportionalOutput {
+  public:
+    static const uint8_t TICK_MS = 10;
+
+    typedef void (*EdgeHook)();
+
+    TimeProportionalOutput();
+
+    // ---- General Methods ---------------------------------------------------
+    void begin(uint8_t pin, uint16_t windowMs);
+    void onTick();              // only called from the Timer1 ISR
+    void shutOff();
+    void restartWindow();
+    void setEdgeHook(EdgeHook hook);
+
+    // ---- Setter/Getter Functions -------------------------------------------
+    void setDuty(uint8_t duty);
+    uint8_t duty() const;
+    bool isOn() const;
+
+  private:
+    volatile uint8_t* _port;
+    uint8_t _mask;
+    uint16_t _windowTicks;
+    volatile uint16_t _tick;        // position in the current window
+    volatile uint16_t _onTicks;     // for the current window
+    volatile uint16_t _nextOnTicks; // latched at the start of the next one
+    uint8_t _duty;
+    bool _restartWindow;            // next setDuty() starts a new window
+    EdgeHook _edgeHook;
+};
+
+extern TimeProportionalOutput timedSsr;
+
+#endif // TIME_PROPORTIONAL_OUTPUT_H
@@ -0,0 +1,250 @@
+#ifndef LM19_H
+#define LM19_H
+
+#include <Arduino.h>
+
+/******************************************************************************
+ DESCRIPTION: Driver for the TI LM19 analog temperature sensor on the
+  ATtiny84A, shared by the Temperature Controller and the POC/TEST sketches
+  so they all read the sensor with the same code.
+
+ NOTES:
+  - Usage:
+      typedef Lm19<7, Lm19OnVcc5V> TempSensor;     // LM19 on ADC7 (PA7)
+      float tempF = TempSensor::readF();            // float, straight-line fit
+      TempCF cf   = TempSensor::posToCF(TempSensor::readPos());   // integer
+  - A calibration is a struct of compile-time settings; Lm19OnVcc5V is the
+    plain one. It supplies:
+      * FULL_SCALE_V: LM19 volts at ADC full scale: the reference, times
+        whatever divider sits between the LM19 and the pin.
+      * INTERNAL_REF: read against the 1.1 V bandgap instead of Vcc.
+  - Lm19Curve holds everything that depends only on the calibration: the
+    datasheet curve as a PROGMEM lookup table and the conversions through
+    it. Lm19 adds the ADC side for one channel. Two LM19s on the same
+    calibration share one table.
+  - Readings are handed about as table positions: the average ADC reading
+    with POS_FRAC fraction bits, i.e. the sum of Samples readings shifted
+    up by SUM_FRAC. Averaging keeps ADC noise out, and the fraction bits
+    keep an EMA on the position from stalling a whole count short. Counts
+    FALL as temperature rises.
+  - posToCF() gives hundredths of a °F (the sketch's TempCF) from the table,
+    which is the datasheet's curve rather than the straight-line fit the
+    float readC()/readF() use. Both clamp to 0.2 V .. 2.8 V first, the range
+    the LM19 can actually put out.
+  - readSum()/readPos() block on analogRead(), about 0.1 ms a reading, and
+    move the ADC to the bandgap and back for INTERNAL_REF calibrations
+    (throwing away the first reading after each switch, which is off).
+    start()/poll() take one reading without waiting for it, for a sketch
+    that has other work to do meanwhile.
+  - Everything is static and templated, so like FastPin this lives
+    entirely in the header and only what a sketch calls reaches its flash;
+    a float-free sketch never pulls in the float accessors.
+  - Put software/libraries on the Arduino sketchbook's library path (or
+    copy LM19/ into it) so #include <LM19.h> finds this.
+*******************************************************************************/
+
+// ---------------- Datasheet -------------------------------------------------
+constexpr float LM19_V0C     = 1.8663;    // V at 0 °C, straight-line fit
+constexpr float LM19_SLOPE   = 0.01169;   // V/°C; T = (1.8663 - V)/0.01169
+// Datasheet transfer curve, which the two above are a straight-line fit to:
+//   V = LM19_A * T^2 + LM19_B * T + LM19_C, T in °C
+constexpr float LM19_A       = -3.88e-6;
+constexpr float LM19_B       = -1.15e-2;
+constexpr float LM19_C       = 1.8639;
+constexpr float LM19_LOW_V   = 0.2;       // sanity clamp on a reading
+constexpr float LM19_HIGH_V  = 2.8;
+
+// ---------------- Calibrations ----------------------------------------------
+struct Lm19OnVcc5V {
+  static constexpr float FULL_SCALE_V = 5.0;
+  static const bool INTERNAL_REF = false;
+};
+
+template <class Cal>
+class Lm19Curve {
+  public:
+    static const uint8_t  POS_FRAC  = 6;                  // fraction bits of a position
+    static const uint8_t  LUT_SHIFT = 5 + POS_FRAC;       // one entry per 32 ADC counts
+    static const uint8_t  LUT_SIZE  = ((1023UL << POS_FRAC) >> LUT_SHIFT) + 2;
+
+    // The sanity clamp as table positions. Below 2.8 V full scale the top
+    // of the ADC's range is the clamp.
+    static constexpr float    HIGH_V  = LM19_HIGH_V < Cal::FULL_SCALE_V ? LM19_HIGH_V : Cal::FULL_SCALE_V;
+    static constexpr uint16_t MIN_POS = (uint16_t)(LM19_LOW_V * 1023.0f / Cal::FULL_SCALE_V * (1 << POS_FRAC) + 0.5f);
+    static constexpr uint16_t MAX_POS = (uint16_t)(HIGH_V * 1023.0f / Cal::FULL_SCALE_V * (1 << POS_FRAC) + 0.5f);
+
+    // ---- Compile-Time Helpers ----------------------------------------------
+
+    // Position at a temperature (hundredths of a °F), straight from the
+    // datasheet curve. For constants only; it is all float.
+    static constexpr uint16_t constPos(int16_t tempCF) {
+      return (uint16_t)(curveV((tempCF / 100.0f - 32.0f) / 1.8f) *
+                        1023.0f / Cal::FULL_SCALE_V * (1 << POS_FRAC) + 0.5f);
+    }
+
+    // The curve inverted for T, in hundredths of °F, at table entry i.
+    // Past the ends of the int16_t range it is pinned there; the clamp keeps
+    // readings well clear of those entries.
+    static constexpr int16_t lutCF(uint8_t i) {
+      return pinCF(tempC((float)((uint32_t)i << LUT_SHIFT >> POS_FRAC) *
+                         Cal::FULL_SCALE_V / 1023.0f) * 1.8f + 32.0f);
+    }
+
+    // ---- General Methods ---------------------------------------------------
+
+    // Clamp a position to the 0.2 V .. 2.8 V sanity range.
+    static uint16_t clampPos(uint16_t pos) {
+      if (pos < MIN_POS) return MIN_POS;
+      if (pos > MAX_POS) return MAX_POS;
+      return pos;
+    }
+
+    // Temperature at a position, interpolating between table entries; the
+    // curve bends so little that this is within 0.05 °F of it.
+    static int16_t posToCF(uint16_t pos) {
+      static_assert(lutCF((MAX_POS >> LUT_SHIFT) + 1) > -32768,
+                    "LM19 clamp reaches past the end of the lookup table");
+      const uint8_t  i    = pos >> LUT_SHIFT;
+      const uint16_t frac = pos & ((1U << LUT_SHIFT) - 1);
+      const int16_t  lo   = (int16_t)pgm_read_word(&LUT_CF[i]);
+      const int16_t  hi   = (int16_t)pgm_read_word(&LUT_CF[i + 1]);
+
+      return lo - (int16_t)(((int32_t)(lo - hi) * frac) >> LUT_SHIFT);
+    }
+
+    // Position a temperature would read as: the table run backwards. Walks
+    // the table and divides, so keep it off the per-sample path.
+    // Temperatures beyond the table's ends come back as its ends.
+    static uint16_t cfToPos(int16_t tempCF) {
+      int16_t lo = (int16_t)pgm_read_word(&LUT_CF[0]);
+      if (tempCF >= lo) return 0;
+
+      for (uint8_t i = 0; i + 1 < LUT_SIZE; i++) {
+        int16_t hi = (int16_t)pgm_read_word(&LUT_CF[i + 1]);
+        if (tempCF > hi) {
+          uint16_t frac = (uint16_t)(((uint32_t)(lo - tempCF) << LUT_SHIFT) / (uint16_t)(lo - hi));
+          return ((uint16_t)i << LUT_SHIFT) + frac;
+        }
+        lo = hi;
+      }
+      return 0xFFFF;
+    }
+
+    // °C from an average ADC reading, by the straight-line fit, with the
+    // same clamp.
+    static float countsToC(float counts) {
+      float v = counts * Cal::FULL_SCALE_V / 1023.0f;
+
+      if (v < LM19_LOW_V)  v = LM19_LOW_V;
+      if (v > LM19_HIGH_V) v = LM19_HIGH_V;
+      return (LM19_V0C - v) / LM19_SLOPE;
+    }
+
+    static const int16_t LUT_CF[LUT_SIZE];
+
+  private:
+    static constexpr float curveV(float tC) {
+      return LM19_A * tC * tC + LM19_B * tC + LM19_C;
+    }
+
+    // Newton's method, so the compiler can build the table
+    static constexpr float sqrtStep(float x, float guess, uint8_t steps) {
+      return steps == 0 ? guess : sqrtStep(x, 0.5f * (guess + x / guess), steps - 1);
+    }
+
+    static constexpr float tempC(float volts) {
+      return (-LM19_B - sqrtStep(LM19_B * LM19_B - 4.0f * LM19_A * (LM19_C - volts),
+                                 LM19_B * LM19_B - 4.0f * LM19_A * (LM19_C - volts), 24)) /
+             (2.0f * LM19_A);
+    }
+
+    static constexpr int16_t pinCF(float tempF) {
+      return tempF >= 327.67f ? 32767 :
+             (tempF <= -327.68f ? -32768 : (int16_t)(tempF * 100.0f + (tempF >= 0.0f ? 0.5f : -0.5f)));
+    }
+};
+
+// The compiler works out every entry, so a change of calibration rebuilds
+// the table. Only a sketch that converts through it gets a copy.
+template <class Cal>
+const int16_t Lm19Curve<Cal>::LUT_CF[Lm19Curve<Cal>::LUT_SIZE] PROGMEM = {
+  lutCF( 0), lutCF( 1), lutCF( 2), lutCF( 3), lutCF( 4), lutCF( 5), lutCF( 6),
+  lutCF( 7), lutCF( 8), lutCF( 9), lutCF(10), lutCF(11), lutCF(12), lutCF(13),
+  lutCF(14), lutCF(15), lutCF(16), lutCF(17), lutCF(18), lutCF(19), lutCF(20),
+  lutCF(21), lutCF(22), lutCF(23), lutCF(24), lutCF(25), lutCF(26), lutCF(27),
+  lutCF(28), lutCF(29), lutCF(30), lutCF(31), lutCF(32) };
+
+constexpr uint8_t lm19Log2(uint8_t n) {
+  return n <= 1 ? 0 : 1 + lm19Log2(n >> 1);
+}
+
+template <uint8_t Channel, class Cal, uint8_t Samples = 8>
+class Lm19 : public Lm19Curve<Cal> {
+  public:
+    typedef Lm19Curve<Cal> Curve;
+
+    static_assert(Channel < 8, "The ATtiny84A's single-ended ADC channels are 0..7");
+    static_assert(Curve::LUT_SIZE == 33, "Lm19Curve::LUT_CF has 33 entries");
+    static_assert(Samples > 0 && Samples <= (1 << Curve::POS_FRAC) && (Samples & (Samples - 1)) == 0,
+                  "Samples must be a power of two, up to 2^POS_FRAC");
+
+    static const uint8_t PIN      = 0x80 | Channel;   // as ATTinyCore's Ax, for analogRead()
+    static const uint8_t SUM_FRAC = Curve::POS_FRAC - lm19Log2(Samples);
+
+    // ---- General Methods ---------------------------------------------------
+
+    // Sum of count plain analogRead() readings.
+    static uint16_t readSum(uint8_t count) {
+      uint16_t sum = 0;
+
+      if (Cal::INTERNAL_REF) {
+        analogReference(INTERNAL1V1);
+        analogRead(PIN);
+      }
+      for (uint8_t i = 0; i < count; i++) {
+        sum += analogRead(PIN);
+      }
+      if (Cal::INTERNAL_REF) {
+        analogReference(DEFAULT);
+        analogRead(PIN);
+      }
+      return sum;
+    }
+
+    // Clamped position from bursts of Samples readings each. More than one
+    // burst is for seeding a filter.
+    static uint16_t readPos(uint8_t bursts = 1) {
+      uint32_t total = 0;
+      for (uint8_t i = 0; i < bursts; i++) {
+        total += readSum(Samples);
+      }
+      return Curve::clampPos((uint16_t)((total << SUM_FRAC) / bursts));
+    }
+
+    // Start one conversion and return at once; poll() has the reading, in
+    // plain ADC counts, when it is done. The ADC must not be busy with
+    // anything else (e.g. a background sampler), and after a change of
+    // reference the first reading should be thrown away.
+    static void start() {
+      const uint8_t refs = Cal::INTERNAL_REF ? _BV(REFS1) : (ADMUX & (_BV(REFS1) | _BV(REFS0)));
+      ADMUX   = refs | Channel;
+      ADCSRA |= _BV(ADSC);
+    }
+
+    static bool poll(uint16_t& counts) {
+      if (ADCSRA & _BV(ADSC)) return false;
+      counts = ADC;
+      return true;
+    }
+
+    // ---- Float Accessors ---------------------------------------------------
+    static float readC() {
+      return Curve::countsToC(readSum(Samples) / (float)Samples);
+    }
+
+    static float readF() {
+      return readC() * 9.0f / 5.0f + 32.0f;
+    }
+};
+
+#endif // LM19_H